@@ -9,10 +9,14 @@ public:
         m_coreAPI = coreAPI;
         
         m_coreAPI->logger().info("ExamplePlugin initialized");
-        m_coreAPI->logger().info("Client: " + info.clientName + " v" + info.clientVersion);
+        m_coreAPI->logger().infof("Client: {} v{}", info.clientName, info.clientVersion);
+
+        m_privateMessages = m_coreAPI->chat().subscribeMessages(
+            PluginSDK::Chat::MessageChannel::Private, {});
     }
     
     void Shutdown() override {
+        m_privateMessages.reset();
         if (m_coreAPI) {
             m_coreAPI->logger().info("ExamplePlugin shutting down");
         }
@@ -26,20 +30,28 @@ public:
         };
     }
     
+    PluginSDK::EventMask GetEventSubscriptions() const override {
+        return {
+            PluginSDK::EventType::AircraftConnected,
+            PluginSDK::EventType::PrivateMessageReceived
+        };
+    }
+
     void OnAircraftConnected(const PluginSDK::Aircraft::AircraftConnectedEvent* event) override {
         if (m_coreAPI) {
-            m_coreAPI->logger().info("Aircraft connected: " + event->callsign);
+            m_coreAPI->logger().infof("Aircraft connected: {}", event->callsign);
         }
     }
     
     void OnPrivateMessageReceived(const PluginSDK::Chat::PrivateMessageReceivedEvent* event) override {
         if (m_coreAPI) {
-            m_coreAPI->logger().info("Private message from " + event->sentFrom + ": " + event->message);
+            m_coreAPI->logger().infof("Private message from {}: {}", event->sentFrom, event->message);
         }
     }
 
 private:
     PluginSDK::CoreAPI* m_coreAPI = nullptr;
+    std::unique_ptr<PluginSDK::Chat::RegistrationToken> m_privateMessages;
 };
 
 extern "C" {
@@ -1,4 +1,7 @@
 #pragma once
+#include "ChangeSet.h"
+#include <cstdint>
+#include <memory_resource>
 #include <string>
 #include <optional>
 #include <vector>
@@ -130,6 +133,21 @@ public:
      */
     virtual std::vector<Aircraft> getAll() = 0;
 
+    /**
+     * @brief Get all aircraft into a caller-owned vector
+     * @param out Replaced with the results, reusing its capacity and the storage
+     * (strings, vectors) of the elements it already holds
+     */
+    virtual void getAll(std::vector<Aircraft>& out) = 0;
+
+    /**
+     * @brief Get all aircraft into a vector allocating from the caller's memory resource
+     * @param out Replaced with the results as by the std::vector overload; only the
+     * vector's own storage comes from its resource, the members of each element use
+     * the default allocator
+     */
+    virtual void getAll(std::pmr::vector<Aircraft>& out) = 0;
+
     /**
      * @brief Get an aircraft by callsign
      * @param callsign The callsign to look up
@@ -153,6 +171,21 @@ public:
      */
     virtual std::optional<double> getDistanceToDestination(const std::string& callsign)
         = 0;
+
+    /**
+     * @brief Get the sequence number of the latest change to aircraft
+     * @return Sequence number, increasing with every insert, update and removal
+     */
+    virtual std::uint64_t getSequence() = 0;
+
+    /**
+     * @brief Get the callsigns of aircraft changed after a sequence number
+     * @param sequence Value of getSequence() or ChangeSet::sequence
+     * @return Net changes since sequence. The change log is bounded, so a
+     * sequence it no longer reaches (0 included, once it has wrapped) returns
+     * truncated with empty lists: check truncated and resync from getAll
+     */
+    virtual ChangeSet changesSince(std::uint64_t sequence) = 0;
 };
 
 } // namespace PluginSDK::Aircraft
@@ -1,4 +1,7 @@
 #pragma once
+#include "ChangeSet.h"
+#include <cstdint>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <optional>
@@ -98,6 +101,21 @@ public:
      */
     virtual std::vector<AirportConfig> getConfigurations() = 0;
 
+    /**
+     * @brief Get all airport configurations into a caller-owned vector
+     * @param out Replaced with the results, reusing its capacity and the storage
+     * (strings, vectors) of the elements it already holds
+     */
+    virtual void getConfigurations(std::vector<AirportConfig>& out) = 0;
+
+    /**
+     * @brief Get all airport configurations into a vector allocating from the caller's memory resource
+     * @param out Replaced with the results as by the std::vector overload; only the
+     * vector's own storage comes from its resource, the members of each element use
+     * the default allocator
+     */
+    virtual void getConfigurations(std::pmr::vector<AirportConfig>& out) = 0;
+
     /**
      * @brief Get airport configuration by ICAO code
      * @param icao The ICAO code to look up
@@ -174,6 +192,21 @@ public:
      * @return True if operation was successful, false otherwise
      */
     virtual bool setAirportStatus(const std::string& icao, AirportStatus status) = 0;
+
+    /**
+     * @brief Get the sequence number of the latest change to airport configurations
+     * @return Sequence number, increasing with every insert, update and removal
+     */
+    virtual std::uint64_t getSequence() = 0;
+
+    /**
+     * @brief Get the ICAO codes of airport configurations changed after a sequence number
+     * @param sequence Value of getSequence() or ChangeSet::sequence
+     * @return Net changes since sequence. The change log is bounded, so a
+     * sequence it no longer reaches (0 included, once it has wrapped) returns
+     * truncated with empty lists: check truncated and resync from getConfigurations
+     */
+    virtual ChangeSet changesSince(std::uint64_t sequence) = 0;
 };
 
 } // namespace PluginSDK::Airport
\ No newline at end of file
@@ -0,0 +1,159 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace PluginSDK::Logger {
+
+/**
+ * Binary log file layout (all integers little-endian)
+ *
+ * File header:
+ *   char[4]  magic "NRBL"
+ *   u16      version (BinaryLogVersion)
+ *   u16      reserved, zero
+ *   u64      creation time, nanoseconds since Unix epoch
+ *
+ * Followed by records, each starting with a u8 BinaryLogRecordType:
+ *   Format:  u32 formatId, u8 level, u16 length, char[length] format string
+ *   Message: u32 formatId, u64 timestamp (ns since Unix epoch), u8 argCount,
+ *            then per argument a u8 LogArgumentType and its payload:
+ *            Int i64, UInt u64, Double f64, Bool u8, String u16 length + bytes
+ *   End:     zero byte, the remainder of a preallocated file is unused
+ *
+ * Every file of a rotation starts by repeating the Format records in use, so
+ * each file can be decoded on its own.
+ */
+inline constexpr char BinaryLogMagic[4] = { 'N', 'R', 'B', 'L' };
+inline constexpr std::uint16_t BinaryLogVersion = 1;
+
+enum class BinaryLogRecordType : std::uint8_t { End = 0, Format = 1, Message = 2 };
+
+enum class LogArgumentType : std::uint8_t { Int = 1, UInt = 2, Double = 3, Bool = 4, String = 5 };
+
+using LogFormatId = std::uint32_t;
+
+/**
+ * @struct LogArgument
+ * @brief Raw argument of a structured log record
+ *
+ * String arguments are views and only need to stay valid for the logging call.
+ */
+struct LogArgument {
+    LogArgumentType type = LogArgumentType::Int;
+    union {
+        std::int64_t i;
+        std::uint64_t u;
+        double d;
+        bool b;
+    };
+    std::string_view s;
+
+    LogArgument(bool value)
+        : type(LogArgumentType::Bool)
+        , b(value)
+    {
+    }
+
+    template <typename T,
+        std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    LogArgument(T value)
+    {
+        if constexpr (std::is_signed_v<T>) {
+            type = LogArgumentType::Int;
+            i = value;
+        } else {
+            type = LogArgumentType::UInt;
+            u = value;
+        }
+    }
+
+    LogArgument(double value)
+        : type(LogArgumentType::Double)
+        , d(value)
+    {
+    }
+
+    LogArgument(std::string_view value)
+        : type(LogArgumentType::String)
+        , u(0)
+        , s(value)
+    {
+    }
+
+    LogArgument(const char* value)
+        : LogArgument(std::string_view(value))
+    {
+    }
+
+    LogArgument(const std::string& value)
+        : LogArgument(std::string_view(value))
+    {
+    }
+};
+
+namespace detail {
+template <std::size_t Size> struct UnsignedOfSize;
+template <> struct UnsignedOfSize<1> { using type = std::uint8_t; };
+template <> struct UnsignedOfSize<2> { using type = std::uint16_t; };
+template <> struct UnsignedOfSize<4> { using type = std::uint32_t; };
+template <> struct UnsignedOfSize<8> { using type = std::uint64_t; };
+} // namespace detail
+
+/**
+ * @brief Append an integer, enum or floating-point value in little-endian byte order
+ * @param out Buffer to append to
+ * @param value Value to encode
+ */
+template <typename T> void writeLittleEndian(std::string& out, T value)
+{
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+    using Bits = typename detail::UnsignedOfSize<sizeof(T)>::type;
+    Bits bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>(static_cast<std::uint8_t>(bits >> (8 * i))));
+    }
+}
+
+/**
+ * @brief Read a value written by writeLittleEndian
+ * @param data At least sizeof(T) bytes
+ * @return Decoded value
+ */
+template <typename T> T readLittleEndian(const char* data)
+{
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+    using Bits = typename detail::UnsignedOfSize<sizeof(T)>::type;
+    Bits bits = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        const auto byte = static_cast<Bits>(static_cast<std::uint8_t>(data[i]));
+        bits = static_cast<Bits>(bits | byte << (8 * i));
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+        return bits != 0;
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+/**
+ * @struct BinaryLogOptions
+ * @brief Output settings of the binary log mode
+ */
+struct BinaryLogOptions {
+    bool enabled = false;
+    // Directory receiving the .nrbl files, the default log directory when empty
+    std::filesystem::path directory;
+    // A new file is started once the current one reaches this size
+    std::size_t maxFileSize = 64 * 1024 * 1024;
+    // Oldest files are deleted beyond this count
+    std::size_t maxFiles = 8;
+};
+
+} // namespace PluginSDK::Logger
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PluginSDK {
+
+/**
+ * @struct ChangeSet
+ * @brief Keys of an entity store changed after a sequence number
+ *
+ * Each key appears in at most one list, with its net change over the range:
+ * a key inserted then updated is inserted, one inserted then removed is left
+ * out, and one removed then inserted again is updated. Fetch the current
+ * values with getByCallsign (getConfigurationByIcao for airports).
+ */
+struct ChangeSet {
+    // Sequence number the changes run up to; pass it to the next changesSince
+    std::uint64_t sequence = 0;
+    // The host's bounded change log no longer reaches back to the requested
+    // sequence number; the lists are empty and the caller must resync from getAll
+    bool truncated = false;
+    std::vector<std::string> inserted;
+    std::vector<std::string> updated;
+    std::vector<std::string> removed;
+};
+
+} // namespace PluginSDK
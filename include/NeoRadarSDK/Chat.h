@@ -1,6 +1,10 @@
 #pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <array>
@@ -27,6 +31,30 @@ struct CommandDefinition {
     bool lastParameterHasSpaces = false;
 };
 
+// Command argument parsed and validated by the host
+struct CommandArgument {
+    ParameterType type = ParameterType::String;
+    // View into ParsedCommandArguments::line
+    std::string_view text;
+    // Set for Number parameters
+    double number = 0.0;
+    // Set for Boolean parameters
+    bool boolean = false;
+};
+
+// Arguments of one command invocation, valid for the duration of the call only
+struct ParsedCommandArguments {
+    std::string_view line;
+    const CommandArgument* arguments = nullptr;
+    std::size_t count = 0;
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const CommandArgument& operator[](std::size_t index) const { return arguments[index]; }
+    const CommandArgument* begin() const { return arguments; }
+    const CommandArgument* end() const { return arguments + count; }
+};
+
 struct ClientTextMessageEvent {
     std::string sentFrom;
     std::string message;
@@ -35,6 +63,21 @@ struct ClientTextMessageEvent {
     bool useDedicatedChannel = false;
 };
 
+struct ClientMessageQueueOptions {
+    // Messages to the same channel queued within this window are sent as one
+    std::chrono::milliseconds mergeWindow { 250 };
+    // Messages queued while the queue is full are dropped
+    std::size_t capacity = 256;
+};
+
+struct ClientMessageQueueStats {
+    std::size_t depth = 0;
+    std::size_t capacity = 0;
+    std::uint64_t sent = 0;
+    std::uint64_t merged = 0;
+    std::uint64_t dropped = 0;
+};
+
 /**
  * @enum RequestType
  * @brief Type of flightplan request
@@ -128,6 +171,62 @@ struct AtcMessageReceivedEvent {
     std::string message;
 };
 
+/**
+ * @enum MessageChannel
+ * @brief Channel of a received text message
+ */
+enum class MessageChannel { Frequency, Private, Broadcast, Supervisor, Server, Atc };
+
+/**
+ * @struct MessageFilter
+ * @brief Host-side filter for a message subscription
+ *
+ * Every non-empty criterion must match; within a list any entry may match.
+ */
+struct MessageFilter {
+    // Frequencies in the same unit as FrequencyMessageReceivedEvent::frequencies
+    std::vector<int> frequencies;
+    std::vector<std::string> senderPrefixes;
+    // Matched case-insensitively as whole words
+    std::vector<std::string> keywords;
+    // ECMAScript regular expression searched in the message text
+    std::optional<std::string> pattern;
+};
+
+/**
+ * @struct ChatHistoryEntry
+ * @brief Message kept in the host's bounded per-channel history
+ */
+struct ChatHistoryEntry {
+    // Monotonically increasing across all channels
+    std::uint64_t sequence = 0;
+    MessageChannel channel;
+    std::string sentFrom;
+    // Recipient of private messages
+    std::string sentTo;
+    std::string message;
+    std::vector<int> frequencies;
+    bool fromMe = false;
+    // (ISO string format)
+    std::string timestamp;
+};
+
+/**
+ * @struct ChatHistoryQuery
+ * @brief Query over the chat history; unset criteria match everything
+ */
+struct ChatHistoryQuery {
+    std::optional<MessageChannel> channel;
+    std::optional<int> frequency;
+    // Sender, recipient or callsign mentioned in the message text
+    std::optional<std::string> callsign;
+    // Matched case-insensitively as a whole word
+    std::optional<std::string> keyword;
+    // Only return entries older than this sequence, for paging
+    std::optional<std::uint64_t> beforeSequence;
+    std::size_t limit = 20;
+};
+
 // Command validation result
 struct ValidationResult {
     bool isValid;
@@ -149,6 +248,19 @@ public:
         const std::string& commandId, const std::vector<std::string>& args)
         = 0;
 
+    // Execute a command with arguments already validated against its
+    // CommandDefinition. The host calls this overload; the default forwards to
+    // Execute so existing providers keep working.
+    virtual CommandResult ExecuteParsed(
+        const std::string& commandId, const ParsedCommandArguments& args)
+    {
+        std::vector<std::string> strings;
+        strings.reserve(args.size());
+        for (const CommandArgument& argument : args) {
+            strings.emplace_back(argument.text);
+        }
+        return Execute(commandId, strings);
+    }
 };
 
 // Registration token
@@ -182,6 +294,10 @@ public:
      *
      * @note The following command names are reserved and cannot be registered:
      *       "hello", "wx", "clear", "dev", "rings", "vis", "wallop", "chat", "center"
+     *
+     * @note The definition is compiled into a parser once, here. Arguments that do
+     *       not match their parameter type or length are rejected before the
+     *       provider is called.
      */
     virtual std::string registerCommand(const std::string& name,
         const CommandDefinition& definition, std::shared_ptr<CommandProvider> provider)
@@ -189,7 +305,60 @@ public:
 
     virtual bool unregisterCommand(const std::string& commandId) = 0;
 
+    /**
+     * @brief Complete a partially typed command name
+     *
+     * @param prefix Command name prefix without dot prefix
+     * @param maxResults Maximum number of names to return
+     * @return Registered command names starting with prefix, in lexical order
+     */
+    virtual std::vector<std::string> completeCommand(
+        const std::string& prefix, std::size_t maxResults)
+        = 0;
+
     virtual void sendClientMessage(const ClientTextMessageEvent message) = 0;
+
+    /**
+     * @brief Queue a client message for batched delivery
+     *
+     * @param message Message to send; messages with isUrgent set skip the queue and
+     * are sent immediately
+     * @return True if queued or sent, false if dropped because the queue is full
+     *
+     * @note Queued messages sharing a channel (sentFrom and useDedicatedChannel)
+     *       within the merge window are combined into one chat entry.
+     */
+    virtual bool queueClientMessage(ClientTextMessageEvent message) = 0;
+
+    virtual void setClientMessageQueueOptions(const ClientMessageQueueOptions& options) = 0;
+
+    virtual ClientMessageQueueStats getClientMessageQueueStats() = 0;
+
+    /**
+     * @brief Subscribe to received messages of one channel
+     *
+     * @param channel Channel to subscribe to
+     * @param filter Filter evaluated by the host before the event is built
+     * @return Token that will automatically unsubscribe when destroyed, nullptr if
+     * the filter is invalid (e.g. malformed pattern)
+     *
+     * @note The matching BasePlugin message handlers are only called for messages
+     *       accepted by at least one of the plugin's subscriptions.
+     */
+    virtual std::unique_ptr<RegistrationToken> subscribeMessages(
+        MessageChannel channel, const MessageFilter& filter)
+        = 0;
+
+    /**
+     * @brief Query the chat history
+     *
+     * @param query Criteria and maximum number of entries
+     * @return Matching entries, newest first
+     *
+     * @note The host keeps a fixed number of messages per channel and indexes them
+     *       by callsign and keyword, so only matching entries are copied.
+     */
+    virtual std::vector<ChatHistoryEntry> queryHistory(const ChatHistoryQuery& query) = 0;
 };
 
 } // namespace PluginSDK::Chat
\ No newline at end of file
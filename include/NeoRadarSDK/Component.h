@@ -0,0 +1,178 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <string>
+#include <type_traits>
+
+namespace PluginSDK::Component {
+
+/**
+ * @enum EntityKind
+ * @brief Host entity records components can be attached to, all keyed by callsign
+ */
+enum class EntityKind : std::uint8_t {
+    // Removed after OnAircraftDisconnected
+    Aircraft,
+    // Removed after OnFlightplanRemoved
+    Flightplan,
+    // Removed after OnControllerDisconnected
+    Controller
+};
+
+/**
+ * @brief Identifier of a registered component type; 0 is never a valid one
+ */
+using ComponentId = std::uint32_t;
+
+/**
+ * @struct EntityHandle
+ * @brief Direct reference to a host entity record
+ *
+ * A handle stays valid until its entity is removed; after that every lookup
+ * through it fails, even if an entity with the same callsign reappears.
+ */
+struct EntityHandle {
+    EntityKind kind = EntityKind::Aircraft;
+    std::uint32_t index = 0;
+    // 0 marks an invalid handle
+    std::uint32_t generation = 0;
+
+    explicit operator bool() const { return generation != 0; }
+    bool operator==(const EntityHandle& other) const
+    {
+        return kind == other.kind && index == other.index && generation == other.generation;
+    }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * @struct ComponentType
+ * @brief Type-erased layout and lifetime functions of a component type
+ */
+struct ComponentType {
+    std::size_t size = 0;
+    std::size_t alignment = 0;
+    // Default-constructs a component in uninitialized storage
+    void (*construct)(void* storage) = nullptr;
+    void (*destroy)(void* component) = nullptr;
+
+    template <typename T> static ComponentType of()
+    {
+        static_assert(std::is_default_constructible_v<T>, "components must be default constructible");
+        return { sizeof(T), alignof(T), [](void* storage) { new (storage) T(); },
+            [](void* component) { static_cast<T*>(component)->~T(); } };
+    }
+};
+
+/**
+ * @interface ComponentAPI
+ * @brief Host-managed per-entity plugin state
+ *
+ * The host stores a plugin's components next to its own entity records, so
+ * reaching them through an EntityHandle is an index lookup, and destroys them
+ * once the plugin has handled the event removing the entity. Components are
+ * created on first access. All methods must be called from the plugin's main
+ * thread (see Scheduler::SchedulerAPI). The host destroys the remaining
+ * components after Shutdown returns.
+ */
+class ComponentAPI {
+public:
+    virtual ~ComponentAPI() = default;
+
+    /**
+     * @brief Register a component type attached to every entity of a kind
+     * @param kind Entities the component belongs to
+     * @param type Layout and lifetime functions, see ComponentType::of
+     * @return Component identifier, 0 if type is invalid
+     */
+    virtual ComponentId registerComponent(EntityKind kind, const ComponentType& type) = 0;
+
+    /**
+     * @brief Find the record of an entity
+     * @param kind Entity kind
+     * @param callsign Entity callsign
+     * @return Handle to the entity, invalid if the host does not know it
+     */
+    virtual EntityHandle findEntity(EntityKind kind, const std::string& callsign) = 0;
+
+    /**
+     * @brief Get the component of an entity, creating it on first access
+     * @param component Registered component
+     * @param entity Entity of the component's kind
+     * @return Component storage, nullptr if the entity was removed or is of another kind
+     */
+    virtual void* getComponent(ComponentId component, EntityHandle entity) = 0;
+
+    /**
+     * @brief Get the component of an entity by callsign, creating it on first access
+     * @return Component storage, nullptr if the host does not know the entity
+     */
+    virtual void* getComponent(ComponentId component, const std::string& callsign) = 0;
+
+    /**
+     * @brief Call a function for every existing component of a type
+     * @param component Registered component
+     * @param function Called with the entity's callsign and the component; it
+     * must not create or access components of other entities of the same kind
+     */
+    virtual void forEachComponent(ComponentId component,
+        const std::function<void(const std::string& callsign, void* component)>& function)
+        = 0;
+};
+
+/**
+ * @class ComponentStore
+ * @brief Typed view of a component registered with ComponentAPI
+ *
+ * Replaces a plugin-side map from callsign to state that must be cleaned up by
+ * hand on every disconnect:
+ * @code
+ * struct Track { int updates = 0; };
+ * m_tracks = ComponentStore<Track>(core->component(), EntityKind::Aircraft);
+ * ...
+ * if (Track* track = m_tracks.get(event->callsign)) ++track->updates;
+ * @endcode
+ */
+template <typename T> class ComponentStore {
+public:
+    ComponentStore() = default;
+
+    ComponentStore(ComponentAPI& api, EntityKind kind)
+        : m_api(&api)
+        , m_id(api.registerComponent(kind, ComponentType::of<T>()))
+    {
+    }
+
+    ComponentId id() const { return m_id; }
+
+    T* get(EntityHandle entity) const
+    {
+        return m_id ? static_cast<T*>(m_api->getComponent(m_id, entity)) : nullptr;
+    }
+
+    T* get(const std::string& callsign) const
+    {
+        return m_id ? static_cast<T*>(m_api->getComponent(m_id, callsign)) : nullptr;
+    }
+
+    /**
+     * @brief Call function(callsign, component) for every existing component
+     */
+    template <typename Function> void forEach(Function&& function) const
+    {
+        if (!m_id) {
+            return;
+        }
+        m_api->forEachComponent(m_id, [&](const std::string& callsign, void* component) {
+            function(callsign, *static_cast<T*>(component));
+        });
+    }
+
+private:
+    ComponentAPI* m_api = nullptr;
+    ComponentId m_id = 0;
+};
+
+} // namespace PluginSDK::Component
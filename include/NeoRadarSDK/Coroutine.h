@@ -0,0 +1,281 @@
+#pragma once
+#include "SDK.h"
+
+// Coroutine support needs C++20; the rest of the SDK stays usable from C++17
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+#if defined(__cpp_lib_coroutine)
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace PluginSDK::Async {
+
+/**
+ * @struct Cancelled
+ * @brief Thrown from a co_await the host cancelled, unwinding the coroutine
+ */
+struct Cancelled : std::exception {
+    const char* what() const noexcept override { return "wait cancelled by the host"; }
+};
+
+/**
+ * @struct Task
+ * @brief Return type of plugin coroutines
+ *
+ * A Task starts running when called and destroys itself when it finishes; it
+ * cannot be awaited. An exception escaping the coroutine calls std::terminate,
+ * as it would escaping a thread, except Cancelled, which ends the coroutine. Awaiting coroutines are resumed by the host on
+ * the plugin's main thread (see Scheduler::SchedulerAPI), so they need no locks
+ * against the plugin's event handlers:
+ * @code
+ * Async::Task TrackAndSquawk(CoreAPI& core, std::string callsign) {
+ *     co_await Async::nextEvent<EventType::AircraftOwnedByChanged>(core, callsign);
+ *     co_await Async::nextEvent<EventType::FlightplanRouteChanged>(core, callsign);
+ *     core.squawk().assignSquawks({ callsign });
+ * }
+ * @endcode
+ *
+ * The host cancels the waits still pending when the plugin unloads, before
+ * Shutdown: nextEvent and delay then throw Cancelled, so the coroutine unwinds
+ * and its frame is freed. Catch it to clean up, and do not wait again.
+ */
+struct Task {
+    struct promise_type {
+        Task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept { }
+        void unhandled_exception() noexcept
+        {
+            try {
+                throw;
+            } catch (const Cancelled&) {
+            } catch (...) {
+                std::terminate();
+            }
+        }
+    };
+};
+
+/**
+ * @struct SquawkAssignment
+ * @brief Owned copy of a Squawk::SquawkAssignedEvent, whose strings are borrowed
+ */
+struct SquawkAssignment {
+    std::string callsign;
+    std::string squawk;
+    std::string providerName;
+};
+
+/**
+ * @brief Type nextEvent returns for an event payload
+ */
+template <typename Payload> struct AwaitedEvent {
+    using type = Payload;
+    static type copy(const Payload& event) { return event; }
+};
+
+template <> struct AwaitedEvent<Squawk::SquawkAssignedEvent> {
+    using type = SquawkAssignment;
+    static type copy(const Squawk::SquawkAssignedEvent& event)
+    {
+        const auto text = [](const char* value) { return value ? std::string(value) : std::string(); };
+        return { text(event.callsign), text(event.squawk), text(event.providerName) };
+    }
+};
+
+/**
+ * @class NextEventAwaiter
+ * @brief Awaitable completing with the next matching event of a type
+ *
+ * The wait's token and result live in state shared with the callback: once
+ * registered, the wait may complete on the main thread and destroy the
+ * awaiter before waitForEvent has returned on a worker thread.
+ */
+template <EventType Type> class NextEventAwaiter {
+public:
+    using Payload = EventPayloadType<Type>;
+    using Result = typename AwaitedEvent<Payload>::type;
+    static_assert(!std::is_void_v<Payload>, "TagShowDropdown cannot be awaited");
+
+    NextEventAwaiter(Scheduler::SchedulerAPI& scheduler, std::function<bool(const Payload&)> filter)
+        : m_scheduler(scheduler)
+        , m_filter(std::move(filter))
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        auto state = std::make_shared<WaitState>();
+        m_state = state;
+        // No member may be touched once the wait is registered
+        auto token = m_scheduler.waitForEvent(
+            Type,
+            [filter = std::move(m_filter)](const void* event) {
+                return !filter || filter(*static_cast<const Payload*>(event));
+            },
+            [state, handle](const void* event) {
+                if (event) {
+                    state->result.emplace(
+                        AwaitedEvent<Payload>::copy(*static_cast<const Payload*>(event)));
+                }
+                handle.resume();
+            });
+        state->token = std::move(token);
+    }
+
+    Result await_resume()
+    {
+        if (!m_state->result) {
+            throw Cancelled();
+        }
+        return std::move(*m_state->result);
+    }
+
+private:
+    struct WaitState {
+        std::unique_ptr<Scheduler::RegistrationToken> token;
+        std::optional<Result> result;
+    };
+
+    Scheduler::SchedulerAPI& m_scheduler;
+    std::function<bool(const Payload&)> m_filter;
+    std::shared_ptr<WaitState> m_state;
+};
+
+/**
+ * @class DelayAwaiter
+ * @brief Awaitable resuming on the main thread after a delay
+ */
+class DelayAwaiter {
+public:
+    DelayAwaiter(Scheduler::SchedulerAPI& scheduler, std::chrono::milliseconds delay)
+        : m_scheduler(scheduler)
+        , m_delay(delay)
+    {
+    }
+
+    bool await_ready() const noexcept { return m_delay.count() <= 0; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        auto state = std::make_shared<WaitState>();
+        m_state = state;
+        // As in NextEventAwaiter, the awaiter may be gone once the wait is registered
+        auto token = m_scheduler.waitForDelay(m_delay, [state, handle](bool cancelled) {
+            state->cancelled = cancelled;
+            handle.resume();
+        });
+        state->token = std::move(token);
+    }
+
+    void await_resume()
+    {
+        if (m_state && m_state->cancelled) {
+            throw Cancelled();
+        }
+    }
+
+private:
+    struct WaitState {
+        std::unique_ptr<Scheduler::RegistrationToken> token;
+        bool cancelled = false;
+    };
+
+    Scheduler::SchedulerAPI& m_scheduler;
+    std::chrono::milliseconds m_delay;
+    std::shared_ptr<WaitState> m_state;
+};
+
+/**
+ * @class ThreadSwitchAwaiter
+ * @brief Awaitable moving the coroutine to the worker pool or the main thread
+ */
+class ThreadSwitchAwaiter {
+public:
+    ThreadSwitchAwaiter(Scheduler::SchedulerAPI& scheduler, bool toMain)
+        : m_scheduler(scheduler)
+        , m_toMain(toMain)
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        if (m_toMain) {
+            m_scheduler.postToMain([handle] { handle.resume(); });
+        } else {
+            m_scheduler.post([handle] { handle.resume(); });
+        }
+    }
+
+    void await_resume() noexcept { }
+
+private:
+    Scheduler::SchedulerAPI& m_scheduler;
+    bool m_toMain;
+};
+
+/**
+ * @brief Wait for the next event of a type
+ * @param core Core API of the plugin
+ * @param filter Predicate the event must satisfy; empty accepts any
+ * @return Awaitable yielding a copy of the event
+ */
+template <EventType Type>
+NextEventAwaiter<Type> nextEvent(
+    CoreAPI& core, std::function<bool(const EventPayloadType<Type>&)> filter = {})
+{
+    return { core.scheduler(), std::move(filter) };
+}
+
+/**
+ * @brief Wait for the next event of a type concerning one callsign
+ * @param core Core API of the plugin
+ * @param callsign Callsign the event's callsign field must equal
+ * @return Awaitable yielding a copy of the event
+ */
+template <EventType Type>
+    requires requires(const EventPayloadType<Type>& event, const std::string& callsign) {
+        event.callsign == callsign;
+    }
+NextEventAwaiter<Type> nextEvent(CoreAPI& core, std::string callsign)
+{
+    return { core.scheduler(),
+        [callsign = std::move(callsign)](
+            const EventPayloadType<Type>& event) { return event.callsign == callsign; } };
+}
+
+/**
+ * @brief Suspend for a delay, resuming on the main thread at a host tick
+ */
+inline DelayAwaiter delay(CoreAPI& core, std::chrono::milliseconds duration)
+{
+    return { core.scheduler(), duration };
+}
+
+/**
+ * @brief Continue on the host's worker pool
+ */
+inline ThreadSwitchAwaiter onWorker(CoreAPI& core) { return { core.scheduler(), false }; }
+
+/**
+ * @brief Continue on the plugin's main thread
+ */
+inline ThreadSwitchAwaiter onMain(CoreAPI& core) { return { core.scheduler(), true }; }
+
+} // namespace PluginSDK::Async
+
+#endif
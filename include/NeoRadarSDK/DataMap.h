@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace PluginSDK {
+
+/**
+ * @struct DataKey
+ * @brief Interned key of a DataMap entry
+ *
+ * The key is the 64-bit FNV-1a hash of its name, so the host and every plugin
+ * agree on it without exchanging tables. Names are registered once with
+ * TagInterface::RegisterDataKey, which rejects collisions and enables reverse lookup.
+ */
+struct DataKey {
+    std::uint64_t id = 0;
+
+    constexpr DataKey() = default;
+    constexpr DataKey(std::string_view name)
+        : id(hash(name))
+    {
+    }
+    constexpr DataKey(const char* name)
+        : DataKey(std::string_view(name))
+    {
+    }
+    DataKey(const std::string& name)
+        : DataKey(std::string_view(name))
+    {
+    }
+
+    static constexpr std::uint64_t hash(std::string_view name)
+    {
+        std::uint64_t value = 14695981039346656037ull;
+        for (char c : name) {
+            value ^= static_cast<unsigned char>(c);
+            value *= 1099511628211ull;
+        }
+        return value;
+    }
+
+    constexpr bool operator==(const DataKey& other) const { return id == other.id; }
+    constexpr bool operator!=(const DataKey& other) const { return id != other.id; }
+};
+
+/**
+ * @class DataMap
+ * @brief Small flat key/value map used for tag and dropdown data
+ *
+ * Entries live in one contiguous buffer, allocated on the first insert, so an
+ * empty map is the size of a std::vector and costs no heap. Lookups are
+ * linear, which is faster than a tree for the handful of entries these maps
+ * usually hold. The interface follows std::map: find returns an iterator to a
+ * (key, value) pair, and count, at and erase behave the same way. Entries keep
+ * their insertion order; inserting or erasing invalidates iterators.
+ */
+class DataMap {
+public:
+    using key_type = DataKey;
+    using mapped_type = std::string;
+    using value_type = std::pair<DataKey, std::string>;
+    using Entry = value_type;
+    using size_type = std::size_t;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    DataMap() = default;
+    DataMap(std::initializer_list<value_type> entries)
+    {
+        for (const auto& [key, value] : entries) {
+            set(key, value);
+        }
+    }
+
+    size_type size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+    iterator begin() { return m_entries.begin(); }
+    iterator end() { return m_entries.end(); }
+    const_iterator begin() const { return m_entries.begin(); }
+    const_iterator end() const { return m_entries.end(); }
+
+    /**
+     * @brief Find the entry stored for a key
+     * @param key Key to look up
+     * @return Iterator to the entry, or end() if not present
+     */
+    iterator find(DataKey key)
+    {
+        return std::find_if(m_entries.begin(), m_entries.end(),
+            [key](const value_type& entry) { return entry.first == key; });
+    }
+
+    const_iterator find(DataKey key) const
+    {
+        return std::find_if(m_entries.begin(), m_entries.end(),
+            [key](const value_type& entry) { return entry.first == key; });
+    }
+
+    size_type count(DataKey key) const { return find(key) != end() ? 1 : 0; }
+    bool contains(DataKey key) const { return find(key) != end(); }
+
+    /**
+     * @brief Get the value stored for a key
+     * @throws std::out_of_range if the key is not present
+     */
+    std::string& at(DataKey key)
+    {
+        const iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("DataMap::at");
+        }
+        return it->second;
+    }
+
+    const std::string& at(DataKey key) const
+    {
+        const const_iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("DataMap::at");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Insert or overwrite the value stored for a key
+     * @param key Entry key
+     * @param value Entry value
+     */
+    void set(DataKey key, std::string value) { (*this)[key] = std::move(value); }
+
+    std::string& operator[](DataKey key)
+    {
+        const iterator it = find(key);
+        if (it != end()) {
+            return it->second;
+        }
+        if (m_entries.empty()) {
+            m_entries.reserve(InitialCapacity);
+        }
+        return m_entries.emplace_back(key, std::string()).second;
+    }
+
+    /**
+     * @brief Remove the entry stored for a key
+     * @param key Entry key
+     * @return Number of entries removed, 0 or 1
+     */
+    size_type erase(DataKey key)
+    {
+        const const_iterator it = std::as_const(*this).find(key);
+        if (it == end()) {
+            return 0;
+        }
+        m_entries.erase(it);
+        return 1;
+    }
+
+    iterator erase(const_iterator position) { return m_entries.erase(position); }
+
+    void clear() { m_entries.clear(); }
+
+private:
+    // Capacity reserved by the first insert
+    static constexpr size_type InitialCapacity = 4;
+
+    std::vector<value_type> m_entries;
+};
+
+} // namespace PluginSDK
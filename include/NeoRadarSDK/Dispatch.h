@@ -0,0 +1,68 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace PluginSDK::Dispatch {
+
+/**
+ * @enum DispatchMode
+ * @brief Thread on which the host calls a plugin's event handlers
+ */
+enum class DispatchMode {
+    // Handlers run on the host thread as events occur
+    Inline,
+    // Handlers run on a worker thread owned by the plugin, fed by a bounded queue
+    Isolated
+};
+
+/**
+ * @enum QueuePolicy
+ * @brief How an isolated plugin's event queue accepts new events
+ */
+enum class QueuePolicy {
+    // Wait for the worker to make room when the queue is full
+    Block,
+    // Discard the oldest queued event when the queue is full
+    DropOldest,
+    // Merge a PositionUpdate into the newest queued event if that is a
+    // PositionUpdate too, keeping the newest position of each aircraft, so the
+    // order of other events is kept; the rest wait for room as with Block
+    Merge
+};
+
+/**
+ * @struct DispatchOptions
+ * @brief Event delivery settings of a plugin
+ *
+ * In Isolated mode every CoreAPI method may be called from the worker thread.
+ * OnTagShowDropdown is queued like any other event and the host waits for its
+ * result. Before calling Shutdown the host stops the worker and discards the
+ * events still queued.
+ */
+struct DispatchOptions {
+    DispatchMode mode = DispatchMode::Inline;
+    QueuePolicy policy = QueuePolicy::Block;
+    std::size_t capacity = 1024;
+};
+
+/**
+ * @struct DispatchStats
+ * @brief Event queue counters of a plugin
+ */
+struct DispatchStats {
+    DispatchMode mode = DispatchMode::Inline;
+    std::size_t queueDepth = 0;
+    std::size_t maxQueueDepth = 0;
+    std::size_t capacity = 0;
+    std::uint64_t dispatched = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t merged = 0;
+    // Time the host thread spent waiting for room under QueuePolicy::Block
+    std::chrono::nanoseconds blocked { 0 };
+    // Time the oldest queued event has been waiting
+    std::chrono::nanoseconds lag { 0 };
+    std::chrono::nanoseconds maxLag { 0 };
+};
+
+} // namespace PluginSDK::Dispatch
@@ -0,0 +1,186 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace PluginSDK {
+
+/**
+ * @enum EventType
+ * @brief Identifies each BasePlugin event handler
+ *
+ * Values are stored in recordings; new events must be appended before Count.
+ */
+enum class EventType : std::uint8_t {
+    // Aircraft events
+    AircraftConnected,
+    AircraftDisconnected,
+    PositionUpdate,
+
+    // Airport events
+    AirportAdded,
+    AirportRemoved,
+    AirportStatusChanged,
+    RunwayStatusChanged,
+    AirportConfigurationsUpdated,
+
+    // Controller events
+    AtcPositionUpdate,
+    AtisLinesUpdate,
+    CapabilitiesUpdate,
+    ControllerDisconnected,
+    ControllerConnected,
+    IsControllerATC,
+
+    // Controller Data events
+    ControllerDataUpdated,
+    AircraftBeaconCodeChanged,
+    AircraftHandoffCancelled,
+    AircraftOwnedByChanged,
+    AircraftHandoffRejected,
+    AircraftTerminatedTracking,
+    AircraftInitiatedTracking,
+    AircraftTemporaryAltitudeChanged,
+    AircraftCDMStatusChanged,
+    AircraftScratchpadUpdated,
+    AircraftHeadingChanged,
+    AircraftAssignedSpeedChanged,
+
+    // Flightplan events
+    FlightplanUpdated,
+    FlightplanRemoved,
+    FlightplanVoiceTypeChanged,
+    FlightplanRouteChanged,
+
+    // FSD events
+    FsdError,
+    FsdConnectionStateChange,
+    FsdConnected,
+    FsdDisconnected,
+    FsdConnectionModelUpdated,
+
+    // Text Message events
+    FlightplanMessageReceived,
+    ATISInfoMessageReceived,
+    FrequencyMessageReceived,
+    PrivateMessageReceived,
+    BroadcastMessageReceived,
+    SupervisorMessageReceived,
+    ServerMessageReceived,
+    AtcMessageReceived,
+
+    // Squawk events
+    SquawkAssigned,
+    DuplicateSquawk,
+
+    // Tag events
+    TagAction,
+    TagDropdownAction,
+    TagShowDropdown,
+
+    Count
+};
+
+/**
+ * @brief Get the name of an event type
+ * @param type Event type
+ * @return Handler name without the "On" prefix
+ */
+inline const char* GetEventTypeName(EventType type)
+{
+    static constexpr const char* names[] = { "AircraftConnected", "AircraftDisconnected",
+        "PositionUpdate", "AirportAdded", "AirportRemoved", "AirportStatusChanged",
+        "RunwayStatusChanged", "AirportConfigurationsUpdated", "AtcPositionUpdate",
+        "AtisLinesUpdate", "CapabilitiesUpdate", "ControllerDisconnected",
+        "ControllerConnected", "IsControllerATC", "ControllerDataUpdated",
+        "AircraftBeaconCodeChanged", "AircraftHandoffCancelled", "AircraftOwnedByChanged",
+        "AircraftHandoffRejected", "AircraftTerminatedTracking", "AircraftInitiatedTracking",
+        "AircraftTemporaryAltitudeChanged", "AircraftCDMStatusChanged",
+        "AircraftScratchpadUpdated", "AircraftHeadingChanged", "AircraftAssignedSpeedChanged",
+        "FlightplanUpdated", "FlightplanRemoved", "FlightplanVoiceTypeChanged",
+        "FlightplanRouteChanged", "FsdError", "FsdConnectionStateChange", "FsdConnected",
+        "FsdDisconnected", "FsdConnectionModelUpdated", "FlightplanMessageReceived",
+        "ATISInfoMessageReceived", "FrequencyMessageReceived", "PrivateMessageReceived",
+        "BroadcastMessageReceived", "SupervisorMessageReceived", "ServerMessageReceived",
+        "AtcMessageReceived", "SquawkAssigned", "DuplicateSquawk", "TagAction",
+        "TagDropdownAction", "TagShowDropdown" };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(EventType::Count));
+
+    const auto index = static_cast<std::size_t>(type);
+    return index < static_cast<std::size_t>(EventType::Count) ? names[index] : "Unknown";
+}
+
+/**
+ * @class EventMask
+ * @brief Set of event types a plugin handles
+ *
+ * Returned from BasePlugin::GetEventSubscriptions. The host only builds event
+ * payloads and calls handlers for event types in the mask.
+ */
+class EventMask {
+public:
+    constexpr EventMask() = default;
+    constexpr EventMask(std::initializer_list<EventType> types)
+    {
+        for (EventType type : types) {
+            set(type);
+        }
+    }
+
+    static constexpr EventMask All() { return EventMask(AllBits); }
+    static constexpr EventMask None() { return EventMask(); }
+
+    constexpr EventMask& set(EventType type)
+    {
+        m_bits |= bit(type);
+        return *this;
+    }
+
+    constexpr EventMask& reset(EventType type)
+    {
+        m_bits &= ~bit(type);
+        return *this;
+    }
+
+    constexpr bool test(EventType type) const { return (m_bits & bit(type)) != 0; }
+    constexpr bool any() const { return m_bits != 0; }
+    constexpr bool all() const { return m_bits == AllBits; }
+    constexpr std::uint64_t bits() const { return m_bits; }
+
+    constexpr EventMask operator|(EventMask other) const { return EventMask(m_bits | other.m_bits); }
+    constexpr EventMask operator&(EventMask other) const { return EventMask(m_bits & other.m_bits); }
+    constexpr EventMask operator~() const { return EventMask(~m_bits & AllBits); }
+    constexpr EventMask& operator|=(EventMask other)
+    {
+        m_bits |= other.m_bits;
+        return *this;
+    }
+    constexpr EventMask& operator&=(EventMask other)
+    {
+        m_bits &= other.m_bits;
+        return *this;
+    }
+    constexpr bool operator==(EventMask other) const { return m_bits == other.m_bits; }
+    constexpr bool operator!=(EventMask other) const { return m_bits != other.m_bits; }
+
+private:
+    static_assert(static_cast<std::size_t>(EventType::Count) < 64, "EventMask holds 63 event types");
+    static constexpr std::uint64_t AllBits
+        = (std::uint64_t(1) << static_cast<unsigned>(EventType::Count)) - 1;
+
+    constexpr explicit EventMask(std::uint64_t bits)
+        : m_bits(bits)
+    {
+    }
+
+    static constexpr std::uint64_t bit(EventType type)
+    {
+        return static_cast<unsigned>(type) < static_cast<unsigned>(EventType::Count)
+            ? std::uint64_t(1) << static_cast<unsigned>(type)
+            : 0;
+    }
+
+    std::uint64_t m_bits = 0;
+};
+
+} // namespace PluginSDK
@@ -0,0 +1,160 @@
+#pragma once
+#include "Aircraft.h"
+#include "Airport.h"
+#include "Chat.h"
+#include "Controller.h"
+#include "ControllerData.h"
+#include "Event.h"
+#include "Flightplan.h"
+#include "Fsd.h"
+#include "Squawk.h"
+#include "Tag.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace PluginSDK {
+
+/**
+ * @brief Maps an EventType to the struct its handler receives
+ *
+ * TagShowDropdown maps to void: it returns a result, so it is never batched.
+ */
+template <EventType Type> struct EventPayload {
+    using type = void;
+};
+
+template <EventType Type> using EventPayloadType = typename EventPayload<Type>::type;
+
+#define NEORADAR_EVENT_PAYLOAD(Name, EventStruct)                                         \
+    template <> struct EventPayload<EventType::Name> {                                    \
+        using type = EventStruct;                                                         \
+    };
+
+NEORADAR_EVENT_PAYLOAD(AircraftConnected, Aircraft::AircraftConnectedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftDisconnected, Aircraft::AircraftDisconnectedEvent)
+NEORADAR_EVENT_PAYLOAD(PositionUpdate, Aircraft::PositionUpdateEvent)
+NEORADAR_EVENT_PAYLOAD(AirportAdded, Airport::AirportAddedEvent)
+NEORADAR_EVENT_PAYLOAD(AirportRemoved, Airport::AirportRemovedEvent)
+NEORADAR_EVENT_PAYLOAD(AirportStatusChanged, Airport::AirportStatusChangedEvent)
+NEORADAR_EVENT_PAYLOAD(RunwayStatusChanged, Airport::RunwayStatusChangedEvent)
+NEORADAR_EVENT_PAYLOAD(AirportConfigurationsUpdated, Airport::AirportConfigurationsUpdatedEvent)
+NEORADAR_EVENT_PAYLOAD(AtcPositionUpdate, Controller::AtcPositionUpdateEvent)
+NEORADAR_EVENT_PAYLOAD(AtisLinesUpdate, Controller::AtisLinesUpdateEvent)
+NEORADAR_EVENT_PAYLOAD(CapabilitiesUpdate, Controller::CapabilitiesUpdateEvent)
+NEORADAR_EVENT_PAYLOAD(ControllerDisconnected, Controller::ControllerDisconnectedEvent)
+NEORADAR_EVENT_PAYLOAD(ControllerConnected, Controller::ControllerConnectedEvent)
+NEORADAR_EVENT_PAYLOAD(IsControllerATC, Controller::IsControllerATCEvent)
+NEORADAR_EVENT_PAYLOAD(ControllerDataUpdated, ControllerData::ControllerDataUpdatedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftBeaconCodeChanged, ControllerData::AircraftBeaconCodeChangedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftHandoffCancelled, ControllerData::AircraftHandoffCancelledEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftOwnedByChanged, ControllerData::AircraftOwnedByChangedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftHandoffRejected, ControllerData::AircraftHandoffRejectedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftTerminatedTracking, ControllerData::AircraftTerminatedTrackingEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftInitiatedTracking, ControllerData::AircraftInitiatedTrackingEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftTemporaryAltitudeChanged, ControllerData::AircraftTemporaryAltitudeChangedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftCDMStatusChanged, ControllerData::AircraftCDMStatusChangedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftScratchpadUpdated, ControllerData::AircraftScratchpadUpdatedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftHeadingChanged, ControllerData::AircraftHeadingChangedEvent)
+NEORADAR_EVENT_PAYLOAD(AircraftAssignedSpeedChanged, ControllerData::AircraftAssignedSpeedChangedEvent)
+NEORADAR_EVENT_PAYLOAD(FlightplanUpdated, Flightplan::FlightplanUpdatedEvent)
+NEORADAR_EVENT_PAYLOAD(FlightplanRemoved, Flightplan::FlightplanRemovedEvent)
+NEORADAR_EVENT_PAYLOAD(FlightplanVoiceTypeChanged, Flightplan::FlightplanVoiceTypeChangedEvent)
+NEORADAR_EVENT_PAYLOAD(FlightplanRouteChanged, Flightplan::FlightplanRouteChangedEvent)
+NEORADAR_EVENT_PAYLOAD(FsdError, Fsd::FsdErrorEvent)
+NEORADAR_EVENT_PAYLOAD(FsdConnectionStateChange, Fsd::FsdConnectionStateChangeEvent)
+NEORADAR_EVENT_PAYLOAD(FsdConnected, Fsd::FsdConnectedEvent)
+NEORADAR_EVENT_PAYLOAD(FsdDisconnected, Fsd::FsdDisconnectedEvent)
+NEORADAR_EVENT_PAYLOAD(FsdConnectionModelUpdated, Fsd::FsdConnectionModelUpdatedEvent)
+NEORADAR_EVENT_PAYLOAD(FlightplanMessageReceived, Chat::FlightplanMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(ATISInfoMessageReceived, Chat::ATISInfoMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(FrequencyMessageReceived, Chat::FrequencyMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(PrivateMessageReceived, Chat::PrivateMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(BroadcastMessageReceived, Chat::BroadcastMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(SupervisorMessageReceived, Chat::SupervisorMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(SquawkAssigned, Squawk::SquawkAssignedEvent)
+NEORADAR_EVENT_PAYLOAD(ServerMessageReceived, Chat::ServerMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(AtcMessageReceived, Chat::AtcMessageReceivedEvent)
+NEORADAR_EVENT_PAYLOAD(DuplicateSquawk, Squawk::DuplicateSquawkEvent)
+NEORADAR_EVENT_PAYLOAD(TagAction, Tag::TagActionEvent)
+NEORADAR_EVENT_PAYLOAD(TagDropdownAction, Tag::DropdownActionEvent)
+
+#undef NEORADAR_EVENT_PAYLOAD
+
+/**
+ * @struct BatchedEvent
+ * @brief One event of an EventBatch
+ */
+struct BatchedEvent {
+    EventType type;
+    const void* event;
+
+    /**
+     * @brief Get the payload if the event is of the given type
+     * @return Payload, nullptr for other types
+     */
+    template <EventType Type> const EventPayloadType<Type>* as() const
+    {
+        static_assert(!std::is_void_v<EventPayloadType<Type>>, "Event type is never batched");
+        return type == Type ? static_cast<const EventPayloadType<Type>*>(event) : nullptr;
+    }
+
+    /**
+     * @brief Call a visitor with the typed payload
+     * @param visitor Callable accepting a const reference to every payload struct
+     */
+    template <typename Visitor> void visit(Visitor&& visitor) const
+    {
+        visit(visitor, std::make_index_sequence<static_cast<std::size_t>(EventType::Count)>());
+    }
+
+private:
+    template <typename Visitor, std::size_t... Types>
+    void visit(Visitor& visitor, std::index_sequence<Types...>) const
+    {
+        (visitIf<static_cast<EventType>(Types)>(visitor), ...);
+    }
+
+    template <EventType Type, typename Visitor> void visitIf(Visitor& visitor) const
+    {
+        if constexpr (!std::is_void_v<EventPayloadType<Type>>) {
+            if (type == Type) {
+                visitor(*static_cast<const EventPayloadType<Type>*>(event));
+            }
+        }
+    }
+};
+
+/**
+ * @class EventBatch
+ * @brief Events of one host tick, in the order they occurred
+ *
+ * The batch and its payloads are only valid while OnEventBatch runs; copy
+ * whatever has to be kept.
+ */
+class EventBatch {
+public:
+    EventBatch(const BatchedEvent* events, std::size_t count, std::uint64_t tick)
+        : m_events(events)
+        , m_count(count)
+        , m_tick(tick)
+    {
+    }
+
+    // Host tick the events occurred in
+    std::uint64_t tick() const { return m_tick; }
+
+    std::size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    const BatchedEvent& operator[](std::size_t index) const { return m_events[index]; }
+    const BatchedEvent* begin() const { return m_events; }
+    const BatchedEvent* end() const { return m_events + m_count; }
+
+private:
+    const BatchedEvent* m_events;
+    std::size_t m_count;
+    std::uint64_t m_tick;
+};
+
+} // namespace PluginSDK
@@ -1,6 +1,10 @@
 #pragma once
-
-
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace PluginSDK::Fsd {
 
@@ -118,6 +122,58 @@ struct FsdConnectionModelUpdatedEvent {
     std::string callsign;
 };
 
+/**
+ * @struct FsdPacketView
+ * @brief Raw FSD packet, pointing into the host's buffer
+ *
+ * All views are only valid for the duration of the callback.
+ */
+struct FsdPacketView {
+    // Whole packet without the line terminator
+    std::string_view raw;
+    // Packet type prefix (e.g. "$CQ", "#TM", "@")
+    std::string_view type;
+    // Colon-separated fields following the type, starting with the sender
+    const std::string_view* fields = nullptr;
+    std::size_t fieldCount = 0;
+    bool outgoing = false;
+};
+
+/**
+ * @interface FsdPacketListener
+ * @brief Receiver of subscribed raw FSD packets
+ */
+class FsdPacketListener {
+public:
+    virtual ~FsdPacketListener() = default;
+
+    /**
+     * @brief Called for each packet matching the subscription
+     * @param packet Packet view, valid during this call only
+     *
+     * @note Called on the network thread; copy what you need and return quickly.
+     */
+    virtual void OnFsdPacket(const FsdPacketView& packet) = 0;
+};
+
+/**
+ * @class RegistrationToken
+ * @brief Token representing a packet subscription
+ */
+class RegistrationToken {
+public:
+    virtual ~RegistrationToken() = default;
+
+    // Non-copyable but movable
+    RegistrationToken(const RegistrationToken&) = delete;
+    RegistrationToken& operator=(const RegistrationToken&) = delete;
+    RegistrationToken(RegistrationToken&&) = default;
+    RegistrationToken& operator=(RegistrationToken&&) = default;
+
+protected:
+    RegistrationToken() = default;
+};
+
 /**
  * @interface FsdAPI
  * @brief Interface for FSD (Flight Server Data) operations
@@ -132,6 +188,20 @@ public:
      */
     virtual std::optional<ConnectionInfo> getConnection() = 0;
 
+    /**
+     * @brief Subscribe to raw FSD packets
+     * @param typePrefixes Packet type prefixes to receive (e.g. "$CQ", "#SB")
+     * @param includeOutgoing Whether packets sent by the client are delivered too
+     * @param listener Listener receiving matching packets
+     * @return Token that will automatically unsubscribe when destroyed
+     *
+     * @note Packets are only split into fields when at least one subscription
+     *       matches, and are never copied per subscriber.
+     */
+    virtual std::unique_ptr<RegistrationToken> subscribePackets(
+        const std::vector<std::string>& typePrefixes, bool includeOutgoing,
+        std::shared_ptr<FsdPacketListener> listener)
+        = 0;
 };
 
 } // namespace PluginSDK::Fsd
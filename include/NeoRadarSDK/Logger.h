@@ -1,4 +1,10 @@
 #pragma once
+#include "BinaryLog.h"
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
 
 namespace PluginSDK::Logger {
 
@@ -15,6 +21,42 @@ enum class LogLevel {
     Verbose = 5
 };
 
+namespace detail {
+
+inline void appendFormat(std::ostringstream& out, std::string_view format)
+{
+    out << format;
+}
+
+template <typename T, typename... Rest>
+void appendFormat(
+    std::ostringstream& out, std::string_view format, const T& value, const Rest&... rest)
+{
+    const auto placeholder = format.find("{}");
+    if (placeholder == std::string_view::npos) {
+        out << format;
+        return;
+    }
+    out << format.substr(0, placeholder) << value;
+    appendFormat(out, format.substr(placeholder + 2), rest...);
+}
+
+} // namespace detail
+
+/**
+ * @brief Substitute each {} placeholder with the next argument
+ * @param format Format string
+ * @param args Arguments written with operator<<
+ * @return Formatted message
+ */
+template <typename... Args>
+std::string format(std::string_view format, const Args&... args)
+{
+    std::ostringstream out;
+    detail::appendFormat(out, format, args...);
+    return out.str();
+}
+
 /**
  * @interface LoggerAPI
  * @brief Interface for plugin logging
@@ -65,6 +107,101 @@ public:
      * @param message Message to log
      */
     virtual void verbose(const std::string& message) = 0;
+
+    /**
+     * @brief Check whether messages of a level are written
+     * @param level Log level
+     * @return True if enabled
+     *
+     * @note Reads a cached level and is cheap enough for hot paths.
+     */
+    virtual bool isEnabled(LogLevel level) const = 0;
+
+    /**
+     * @brief Get the number of messages dropped because the log backend was full
+     * @return Dropped message count since startup
+     *
+     * @note Logging does not wait for output: messages are queued to a host writer
+     *       thread, and a message arriving while the queue is full is dropped.
+     */
+    virtual std::uint64_t getDroppedMessageCount() const = 0;
+
+    /**
+     * @brief Log a formatted message; nothing is formatted if the level is disabled
+     * @param level Log level
+     * @param format Format string with {} placeholders
+     * @param args Placeholder arguments
+     */
+    template <typename... Args>
+    void logf(LogLevel level, std::string_view format, const Args&... args)
+    {
+        if (isEnabled(level)) {
+            log(level, Logger::format(format, args...));
+        }
+    }
+
+    template <typename... Args> void fatalf(std::string_view format, const Args&... args)
+    {
+        logf(LogLevel::Fatal, format, args...);
+    }
+
+    template <typename... Args> void errorf(std::string_view format, const Args&... args)
+    {
+        logf(LogLevel::Error, format, args...);
+    }
+
+    template <typename... Args> void warningf(std::string_view format, const Args&... args)
+    {
+        logf(LogLevel::Warning, format, args...);
+    }
+
+    template <typename... Args> void infof(std::string_view format, const Args&... args)
+    {
+        logf(LogLevel::Info, format, args...);
+    }
+
+    template <typename... Args> void debugf(std::string_view format, const Args&... args)
+    {
+        logf(LogLevel::Debug, format, args...);
+    }
+
+    template <typename... Args> void verbosef(std::string_view format, const Args&... args)
+    {
+        logf(LogLevel::Verbose, format, args...);
+    }
+
+    /**
+     * @brief Register a format string for structured logging, typically at startup
+     * @param level Level of the messages using this format
+     * @param format Format string with {} placeholders
+     * @return Format ID to pass to logStructured
+     */
+    virtual LogFormatId registerFormat(LogLevel level, std::string_view format) = 0;
+
+    /**
+     * @brief Log a structured message
+     * @param formatId Format ID returned by registerFormat
+     * @param args Raw arguments, valid for the duration of the call
+     * @param count Number of arguments
+     *
+     * @note In binary mode only the format ID, a timestamp and the raw arguments are
+     *       written; otherwise the host formats the message as text.
+     */
+    virtual void logStructured(LogFormatId formatId, const LogArgument* args, std::size_t count)
+        = 0;
+
+    /**
+     * @brief Enable or reconfigure the binary log mode
+     * @param options Output settings
+     * @return True if successful
+     */
+    virtual bool setBinaryLogging(const BinaryLogOptions& options) = 0;
+
+    template <typename... Args> void logRecord(LogFormatId formatId, const Args&... args)
+    {
+        const std::array<LogArgument, sizeof...(Args)> arguments { LogArgument(args)... };
+        logStructured(formatId, arguments.data(), arguments.size());
+    }
 };
 
 } // namespace PluginSDK
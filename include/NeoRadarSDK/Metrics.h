@@ -0,0 +1,146 @@
+#pragma once
+#include "Event.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PluginSDK::Metrics {
+
+/**
+ * @enum Api
+ * @brief CoreAPI interface a call was made to
+ */
+enum class Api : std::uint8_t {
+    Package,
+    Aircraft,
+    Flightplan,
+    Controller,
+    ControllerData,
+    Airport,
+    Squawk,
+    Tag,
+    Logger,
+    Fsd,
+    Chat,
+    Scheduler,
+    Component,
+    Count
+};
+
+/**
+ * @brief Get the name of a CoreAPI interface
+ * @param api Interface
+ * @return Name of its CoreAPI accessor
+ */
+inline const char* GetApiName(Api api)
+{
+    static constexpr const char* names[] = { "package", "aircraft", "flightplan", "controller",
+        "controllerData", "airport", "squawk", "tag", "logger", "fsd", "chat", "scheduler",
+        "component" };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(Api::Count));
+
+    const auto index = static_cast<std::size_t>(api);
+    return index < static_cast<std::size_t>(Api::Count) ? names[index] : "Unknown";
+}
+
+/**
+ * @struct LatencySummary
+ * @brief Distribution of call durations
+ *
+ * Percentiles come from a log-linear histogram and are within about 3% of
+ * the exact value; count, total and max are exact.
+ */
+struct LatencySummary {
+    std::uint64_t count = 0;
+    std::chrono::nanoseconds total { 0 };
+    std::chrono::nanoseconds p50 { 0 };
+    std::chrono::nanoseconds p99 { 0 };
+    std::chrono::nanoseconds max { 0 };
+};
+
+/**
+ * @struct HandlerMetrics
+ * @brief Handler calls of one event type
+ */
+struct HandlerMetrics {
+    EventType type = EventType::Count;
+    LatencySummary latency;
+    // Calls per second over PluginMetrics::window
+    double rate = 0.0;
+};
+
+/**
+ * @struct ApiMetrics
+ * @brief Calls the plugin made to one CoreAPI interface
+ *
+ * Only the outermost call is timed when a CoreAPI method calls another.
+ */
+struct ApiMetrics {
+    Api api = Api::Count;
+    LatencySummary latency;
+};
+
+/**
+ * @struct AllocationMetrics
+ * @brief Heap use of the plugin
+ *
+ * Allocations and frees are attributed to the plugin whose code is running
+ * on the thread: its handlers, timers and tasks. Memory freed by another
+ * plugin or by the host is not subtracted, and memory the plugin frees that
+ * was allocated before the metrics were reset can make liveBytes negative.
+ */
+struct AllocationMetrics {
+    // False when the host cannot observe the plugin's allocations
+    bool tracked = false;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    std::int64_t liveBytes = 0;
+    std::int64_t peakLiveBytes = 0;
+};
+
+/**
+ * @struct PluginMetrics
+ * @brief Instrumentation of one plugin, since it was loaded or since resetMetrics
+ */
+struct PluginMetrics {
+    // Host time covered
+    std::chrono::nanoseconds window { 0 };
+    // Every handler call, OnEventBatch included
+    LatencySummary handlers;
+    // Event types handled at least once, in EventType order
+    std::vector<HandlerMetrics> events;
+    // OnEventBatch calls
+    LatencySummary batches;
+    // Interfaces called at least once, in Api order
+    std::vector<ApiMetrics> apiCalls;
+    AllocationMetrics allocations;
+    // Scheduler pool tasks that ended by throwing; the host logs each one
+    std::uint64_t taskExceptions = 0;
+};
+
+/**
+ * @interface MetricsAPI
+ * @brief Host instrumentation of the calling plugin
+ *
+ * The host times every handler call and every CoreAPI call, so a plugin can
+ * show its own cost or report it when the scope stutters. Hosts may also log
+ * these metrics periodically.
+ */
+class MetricsAPI {
+public:
+    virtual ~MetricsAPI() = default;
+
+    /**
+     * @brief Get the metrics of the calling plugin
+     */
+    virtual PluginMetrics getMetrics() = 0;
+
+    /**
+     * @brief Restart the histograms, counters and window of the calling plugin
+     */
+    virtual void resetMetrics() = 0;
+};
+
+} // namespace PluginSDK::Metrics
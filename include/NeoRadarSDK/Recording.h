@@ -0,0 +1,269 @@
+#pragma once
+#include "Event.h"
+#include "SDK.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace PluginSDK::Recording {
+
+/**
+ * @enum RecordKind
+ * @brief Kind of a record in a recording file
+ */
+enum class RecordKind : std::uint8_t { End = 0, Event = 1, Snapshot = 2 };
+
+/**
+ * @struct Snapshot
+ * @brief State answered by CoreAPI queries at one point of a recording
+ */
+struct Snapshot {
+    std::vector<Aircraft::Aircraft> aircraft;
+    std::vector<Flightplan::Flightplan> flightplans;
+    std::vector<Controller::Controller> controllers;
+    std::vector<ControllerData::ControllerDataModel> controllerData;
+    std::vector<Airport::AirportConfig> airports;
+    std::optional<Fsd::ConnectionInfo> connection;
+};
+
+/**
+ * @brief Encode a snapshot entity as it is stored in recordings
+ *
+ * Two entities are equal exactly when their encodings are, which lets a replay
+ * host tell which entities changed between snapshots.
+ */
+std::string encode(const Aircraft::Aircraft& aircraft);
+std::string encode(const Flightplan::Flightplan& flightplan);
+std::string encode(const Controller::Controller& controller);
+std::string encode(const ControllerData::ControllerDataModel& controllerData);
+std::string encode(const Airport::AirportConfig& airport);
+
+/**
+ * @class RecordingPlugin
+ * @brief Plugin wrapper writing every event it forwards to a recording file
+ *
+ * Wrap the real plugin in CreatePluginInstance to record a session:
+ * @code
+ * return new PluginSDK::Recording::RecordingPlugin(
+ *     std::make_unique<MyPlugin>(), "session.nrrec");
+ * @endcode
+ * Events are stored with their time since Initialize. A Snapshot of the CoreAPI
+ * query results is written before the first event and then at most once per
+ * snapshot interval, so a replay host can answer the plugin's queries.
+ */
+class RecordingPlugin : public BasePlugin {
+public:
+    RecordingPlugin(std::unique_ptr<BasePlugin> plugin, std::filesystem::path path,
+        std::chrono::milliseconds snapshotInterval = std::chrono::seconds(1));
+    ~RecordingPlugin() override;
+
+    void Initialize(const PluginMetadata& metadata, CoreAPI* coreAPI,
+        ClientInformation info) override;
+    void Shutdown() override;
+    PluginMetadata GetMetadata() const override;
+
+    // Every event is recorded; only those the wrapped plugin subscribes to are forwarded
+    EventMask GetEventSubscriptions() const override { return EventMask::All(); }
+    Dispatch::DispatchOptions GetDispatchOptions() const override;
+    EventMask GetBatchedEvents() const override;
+
+    void OnAircraftConnected(const Aircraft::AircraftConnectedEvent* event) override;
+    void OnAircraftDisconnected(const Aircraft::AircraftDisconnectedEvent* event) override;
+    void OnPositionUpdate(const Aircraft::PositionUpdateEvent* event) override;
+
+    void OnAirportAdded(const Airport::AirportAddedEvent* event) override;
+    void OnAirportRemoved(const Airport::AirportRemovedEvent* event) override;
+    void OnAirportStatusChanged(const Airport::AirportStatusChangedEvent* event) override;
+    void OnRunwayStatusChanged(const Airport::RunwayStatusChangedEvent* event) override;
+    void OnAirportConfigurationsUpdated(
+        const Airport::AirportConfigurationsUpdatedEvent* event) override;
+
+    void OnAtcPositionUpdate(const Controller::AtcPositionUpdateEvent* event) override;
+    void OnAtisLinesUpdate(const Controller::AtisLinesUpdateEvent* event) override;
+    void OnCapabilitiesUpdate(const Controller::CapabilitiesUpdateEvent* event) override;
+    void OnControllerDisconnected(
+        const Controller::ControllerDisconnectedEvent* event) override;
+    void OnControllerConnected(const Controller::ControllerConnectedEvent* event) override;
+    void OnIsControllerATC(const Controller::IsControllerATCEvent* event) override;
+
+    void OnControllerDataUpdated(
+        const ControllerData::ControllerDataUpdatedEvent* event) override;
+    void OnAircraftBeaconCodeChanged(
+        const ControllerData::AircraftBeaconCodeChangedEvent* event) override;
+    void OnAircraftHandoffCancelled(
+        const ControllerData::AircraftHandoffCancelledEvent* event) override;
+    void OnAircraftOwnedByChanged(
+        const ControllerData::AircraftOwnedByChangedEvent* event) override;
+    void OnAircraftHandoffRejected(
+        const ControllerData::AircraftHandoffRejectedEvent* event) override;
+    void OnAircraftTerminatedTracking(
+        const ControllerData::AircraftTerminatedTrackingEvent* event) override;
+    void OnAircraftInitiatedTracking(
+        const ControllerData::AircraftInitiatedTrackingEvent* event) override;
+    void OnAircraftTemporaryAltitudeChanged(
+        const ControllerData::AircraftTemporaryAltitudeChangedEvent* event) override;
+    void OnAircraftCDMStatusChanged(
+        const ControllerData::AircraftCDMStatusChangedEvent* event) override;
+    void OnAircraftScratchpadUpdated(
+        const ControllerData::AircraftScratchpadUpdatedEvent* event) override;
+    void OnAircraftHeadingChanged(
+        const ControllerData::AircraftHeadingChangedEvent* event) override;
+    void OnAircraftAssignedSpeedChanged(
+        const ControllerData::AircraftAssignedSpeedChangedEvent* event) override;
+
+    void OnFlightplanUpdated(const Flightplan::FlightplanUpdatedEvent* event) override;
+    void OnFlightplanRemoved(const Flightplan::FlightplanRemovedEvent* event) override;
+    void OnFlightplanVoiceTypeChanged(
+        const Flightplan::FlightplanVoiceTypeChangedEvent* event) override;
+    void OnFlightplanRouteChanged(const Flightplan::FlightplanRouteChangedEvent* event) override;
+
+    void OnFsdError(const Fsd::FsdErrorEvent* event) override;
+    void OnFsdConnectionStateChange(const Fsd::FsdConnectionStateChangeEvent* event) override;
+    void OnFsdConnected(const Fsd::FsdConnectedEvent* event) override;
+    void OnFsdDisconnected(const Fsd::FsdDisconnectedEvent* event) override;
+    void OnFsdConnectionModelUpdated(const Fsd::FsdConnectionModelUpdatedEvent* event) override;
+
+    void OnFlightplanMessageReceived(const Chat::FlightplanMessageReceivedEvent* event) override;
+    void OnATISInfoMessageReceived(const Chat::ATISInfoMessageReceivedEvent* event) override;
+    void OnFrequencyMessageReceived(const Chat::FrequencyMessageReceivedEvent* event) override;
+    void OnPrivateMessageReceived(const Chat::PrivateMessageReceivedEvent* event) override;
+    void OnBroadcastMessageReceived(const Chat::BroadcastMessageReceivedEvent* event) override;
+    void OnSupervisorMessageReceived(
+        const Chat::SupervisorMessageReceivedEvent* event) override;
+    void OnServerMessageReceived(const Chat::ServerMessageReceivedEvent* event) override;
+    void OnAtcMessageReceived(const Chat::AtcMessageReceivedEvent* event) override;
+
+    void OnSquawkAssigned(const Squawk::SquawkAssignedEvent* event) override;
+    void OnDuplicateSquawk(const Squawk::DuplicateSquawkEvent* event) override;
+
+    void OnTagAction(const Tag::TagActionEvent* event) override;
+    void OnTagDropdownAction(const Tag::DropdownActionEvent* event) override;
+    bool OnTagShowDropdown(const std::string& actionId, const std::string& callsign) override;
+
+    // Batched events are recorded one by one
+    void OnEventBatch(const EventBatch& batch) override;
+
+private:
+    template <typename T> void record(EventType type, const T& event);
+    void writeRecord(RecordKind kind, EventType type);
+
+    std::unique_ptr<BasePlugin> m_plugin;
+    std::filesystem::path m_path;
+    std::chrono::milliseconds m_snapshotInterval;
+    CoreAPI* m_coreAPI = nullptr;
+    // Wrapped plugin's subscriptions, read once it is initialized
+    EventMask m_forwarded = EventMask::All();
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    std::string m_buffer;
+    std::chrono::steady_clock::time_point m_start;
+    std::optional<std::chrono::steady_clock::time_point> m_lastSnapshot;
+};
+
+/**
+ * @class RecordedEvent
+ * @brief Decoded event that can be kept after the reader moves on
+ */
+class RecordedEvent {
+public:
+    virtual ~RecordedEvent() = default;
+
+    virtual EventType type() const = 0;
+
+    /**
+     * @brief Get the event struct matching type()
+     * @note TagShowDropdown events point to a std::pair of action ID and callsign.
+     */
+    virtual void* data() = 0;
+    virtual const void* data() const = 0;
+
+    /**
+     * @brief Deliver the event to a plugin through its matching handler
+     */
+    virtual void dispatch(BasePlugin& plugin) const = 0;
+};
+
+/**
+ * @class RecordingReader
+ * @brief Sequential reader of recording files written by RecordingPlugin
+ */
+class RecordingReader {
+public:
+    RecordingReader();
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    /**
+     * @brief Open a recording and read its header
+     * @param path Recording file
+     * @return True if the file is a readable recording
+     */
+    bool open(const std::filesystem::path& path);
+
+    const PluginMetadata& metadata() const;
+    const ClientInformation& clientInformation() const;
+
+    /**
+     * @brief Read and decode the next record
+     * @return False at the end of the recording or on a malformed record
+     */
+    bool next();
+
+    RecordKind kind() const;
+    EventType eventType() const;
+
+    /**
+     * @brief Time of the current record since the start of the recording
+     */
+    std::chrono::nanoseconds timestamp() const;
+
+    /**
+     * @brief Latest snapshot read, updated by each Snapshot record
+     */
+    const Snapshot& snapshot() const;
+
+    /**
+     * @brief Get the decoded event of the current Event record
+     * @return Pointer to the event struct matching eventType(), nullptr otherwise
+     *
+     * @note TagShowDropdown events point to a std::pair of action ID and callsign.
+     */
+    const void* event() const;
+
+    /**
+     * @brief Copy the decoded event of the current Event record
+     * @return Owned copy, nullptr if the current record is not an event
+     */
+    std::unique_ptr<RecordedEvent> copyEvent() const;
+
+    /**
+     * @brief Take the decoded event of the current Event record without copying it
+     * @return Owned event, nullptr if the current record is not an event
+     *
+     * @note The next record of the same type is decoded into a new event, so
+     *       buffers are not reused for that type. The current record has no event
+     *       afterwards.
+     */
+    std::unique_ptr<RecordedEvent> takeEvent();
+
+    /**
+     * @brief Deliver the current Event record to a plugin
+     * @param plugin Plugin receiving the event through its matching handler
+     */
+    void dispatch(BasePlugin& plugin) const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace PluginSDK::Recording
@@ -1,18 +1,25 @@
 #pragma once
 
-#define PLUGIN_SDK_VERSION_MAJOR 1
+#define PLUGIN_SDK_VERSION_MAJOR 2
 #define PLUGIN_SDK_VERSION_MINOR 0
-#define PLUGIN_SDK_VERSION_PATCH 6
+#define PLUGIN_SDK_VERSION_PATCH 0
 
 #include "Aircraft.h"
 #include "Airport.h"
 #include "Package.h"
+#include "ChangeSet.h"
 #include "Chat.h"
+#include "Component.h"
 #include "Controller.h"
 #include "ControllerData.h"
+#include "Dispatch.h"
+#include "Event.h"
+#include "EventBatch.h"
 #include "Flightplan.h"
 #include "Fsd.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "Scheduler.h"
 #include "Squawk.h"
 #include "Tag.h"
 #include <filesystem>
@@ -116,6 +123,30 @@ public:
    */
   virtual Chat::ChatAPI &chat() = 0;
 
+  /**
+   * @brief Get the scheduler API
+   * @return Reference to the scheduler API
+   */
+  virtual Scheduler::SchedulerAPI &scheduler() = 0;
+
+  /**
+   * @brief Get the component API
+   * @return Reference to the component API
+   */
+  virtual Component::ComponentAPI &component() = 0;
+
+  /**
+   * @brief Get the metrics API
+   * @return Reference to the metrics API
+   */
+  virtual Metrics::MetricsAPI &metrics() = 0;
+
+  /**
+   * @brief Get the event queue counters of the calling plugin
+   * @return Dispatch statistics; only mode is meaningful for inline plugins
+   */
+  virtual Dispatch::DispatchStats getDispatchStats() = 0;
+
 
 };
 
@@ -147,6 +178,40 @@ public:
    */
   virtual PluginMetadata GetMetadata() const = 0;
 
+  /**
+   * @brief Get the events the plugin handles
+   * @return Event types whose handlers the host calls; all by default
+   *
+   * Queried once after Initialize returns. The host does not build payloads
+   * for, or call, handlers of event types outside the mask, so plugins should
+   * list only the handlers they override:
+   * @code
+   * EventMask GetEventSubscriptions() const override {
+   *   return {EventType::AircraftConnected, EventType::TagAction};
+   * }
+   * @endcode
+   */
+  virtual EventMask GetEventSubscriptions() const { return EventMask::All(); }
+
+  /**
+   * @brief Get how the host delivers events to the plugin
+   * @return Dispatch options; inline on the host thread by default
+   *
+   * Queried once after Initialize returns. Plugins with slow handlers should
+   * use DispatchMode::Isolated so they cannot stall the radar display.
+   */
+  virtual Dispatch::DispatchOptions GetDispatchOptions() const { return {}; }
+
+  /**
+   * @brief Get the events delivered through OnEventBatch
+   * @return Event types batched per host tick instead of calling their
+   * handlers; none by default
+   *
+   * Queried once after Initialize returns, and intersected with
+   * GetEventSubscriptions. TagShowDropdown is never batched.
+   */
+  virtual EventMask GetBatchedEvents() const { return EventMask::None(); }
+
   // Aircraft events
   virtual void
   OnAircraftConnected(const Aircraft::AircraftConnectedEvent *event) {}
@@ -229,14 +294,32 @@ public:
   virtual void
   OnATISInfoMessageReceived(const Chat::ATISInfoMessageReceivedEvent *event) {}
 
+  // Subscribed message events (see ChatAPI::subscribeMessages)
+  virtual void OnFrequencyMessageReceived(
+      const Chat::FrequencyMessageReceivedEvent *event) {}
+  virtual void
+  OnPrivateMessageReceived(const Chat::PrivateMessageReceivedEvent *event) {}
+  virtual void OnBroadcastMessageReceived(
+      const Chat::BroadcastMessageReceivedEvent *event) {}
+  virtual void OnSupervisorMessageReceived(
+      const Chat::SupervisorMessageReceivedEvent *event) {}
+  virtual void
+  OnServerMessageReceived(const Chat::ServerMessageReceivedEvent *event) {}
+  virtual void
+  OnAtcMessageReceived(const Chat::AtcMessageReceivedEvent *event) {}
+
   // Squawk events
   virtual void OnSquawkAssigned(const Squawk::SquawkAssignedEvent *event) {}
+  virtual void OnDuplicateSquawk(const Squawk::DuplicateSquawkEvent *event) {}
 
   // Tag events
   virtual void OnTagAction(const Tag::TagActionEvent *event) {}
   virtual void OnTagDropdownAction(const Tag::DropdownActionEvent *event) {}
   virtual bool OnTagShowDropdown(const std::string& actionId, const std::string& callsign) { return true;};
 
+  // Batched events (see GetBatchedEvents)
+  virtual void OnEventBatch(const EventBatch &batch) {}
+
 };
 
 } // namespace PluginSDK
@@ -0,0 +1,168 @@
+#pragma once
+#include "Event.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace PluginSDK::Scheduler {
+
+/**
+ * @brief Unit of work run by the scheduler
+ */
+using Task = std::function<void()>;
+
+/**
+ * @class RegistrationToken
+ * @brief Token representing a timer or event wait; destroying it cancels it
+ */
+class RegistrationToken {
+public:
+    virtual ~RegistrationToken() = default;
+
+    // Non-copyable but movable
+    RegistrationToken(const RegistrationToken&) = delete;
+    RegistrationToken& operator=(const RegistrationToken&) = delete;
+    RegistrationToken(RegistrationToken&&) = default;
+    RegistrationToken& operator=(RegistrationToken&&) = default;
+
+protected:
+    RegistrationToken() = default;
+};
+
+/**
+ * @interface SchedulerAPI
+ * @brief Interface to the host's shared worker pool and frame timers
+ *
+ * All plugins share one pool sized by the host, so plugins should post work
+ * here instead of starting their own threads. "Main thread" below is the thread
+ * the plugin's event handlers run on: the host thread, or the plugin's worker
+ * in Dispatch::DispatchMode::Isolated.
+ *
+ * CoreAPI calls that are safe from pool tasks:
+ * - the queries of AircraftAPI, FlightplanAPI, ControllerAPI, ControllerDataAPI,
+ *   AirportAPI and FsdAPI, getSequence and changesSince included; each call sees
+ *   one consistent snapshot, but two calls may see different ones
+ * - the write calls of those interfaces, SquawkAPI, Tag::TagInterface and LoggerAPI
+ * - ChatAPI; command providers and message subscriptions are still called on
+ *   the main thread
+ * - PackageAPI, MetricsAPI and every SchedulerAPI method
+ *
+ * Component::ComponentAPI must only be called from the main thread.
+ */
+class SchedulerAPI {
+public:
+    virtual ~SchedulerAPI() = default;
+
+    /**
+     * @brief Run a task on the worker pool
+     * @param task Task to run; must not touch plugin state owned by the main thread
+     */
+    virtual void post(Task task) = 0;
+
+    /**
+     * @brief Run a task on the main thread during the next host tick
+     * @param task Task to run; may be posted from any thread
+     */
+    virtual void postToMain(Task task) = 0;
+
+    /**
+     * @brief Run body over [0, count) split into ranges on the worker pool
+     * @param count Number of items
+     * @param body Called with [begin, end) ranges, concurrently from several threads
+     * @param grainSize Items per range; 0 lets the host choose
+     *
+     * Blocks until every range has run. The calling thread runs ranges too, so
+     * parallelFor may be called from a pool task.
+     *
+     * @throws The first exception body threw, rethrown on the calling thread once
+     *         every range is finished. Ranges not started by then are skipped.
+     */
+    virtual void parallelFor(std::size_t count,
+        const std::function<void(std::size_t begin, std::size_t end)>& body,
+        std::size_t grainSize = 0)
+        = 0;
+
+    /**
+     * @brief Add a timer run on the main thread
+     * @param interval Time until the first run and between runs
+     * @param task Task to run
+     * @param repeat Run every interval until the token is destroyed
+     * @return Token keeping the timer alive, nullptr if task is empty
+     *
+     * Timers fire during the host tick in which they become due, so intervals
+     * are effectively rounded up to the tick interval. A repeating timer that
+     * missed several ticks runs once.
+     */
+    virtual std::unique_ptr<RegistrationToken> addTimer(
+        std::chrono::milliseconds interval, Task task, bool repeat = true)
+        = 0;
+
+    /**
+     * @brief Wait once for an event delivered to the plugin
+     * @param type Event type; TagShowDropdown cannot be waited for
+     * @param filter Called on the main thread with each payload of that type;
+     * the first one it accepts completes the wait. Empty accepts any payload
+     * @param callback Called once on the main thread with the accepted payload,
+     * before the plugin's handler, or with nullptr if the host cancels the wait
+     * @return Token cancelling the wait, nullptr if type cannot be waited for
+     * or callback is empty
+     *
+     * Waits are served for event types outside GetEventSubscriptions too. The
+     * payload is only valid during the calls, and the token may be destroyed
+     * from within the callback. Waits still pending when the plugin unloads
+     * are cancelled before Shutdown. See Coroutine.h for awaitables built on
+     * this.
+     */
+    virtual std::unique_ptr<RegistrationToken> waitForEvent(EventType type,
+        std::function<bool(const void* event)> filter,
+        std::function<void(const void* event)> callback)
+        = 0;
+
+    /**
+     * @brief Wait once for a delay
+     * @param delay Time until the callback runs, rounded up to the tick like addTimer
+     * @param callback Called once on the main thread with false when the delay
+     * has passed, or with true if the host cancels the wait before Shutdown
+     * @return Token cancelling the wait without a call, nullptr if callback is empty
+     */
+    virtual std::unique_ptr<RegistrationToken> waitForDelay(
+        std::chrono::milliseconds delay, std::function<void(bool cancelled)> callback)
+        = 0;
+
+    /**
+     * @brief Get the interval of the host tick timers and main-thread tasks run on
+     */
+    virtual std::chrono::milliseconds getTickInterval() const = 0;
+
+    /**
+     * @brief Get the number of threads in the worker pool
+     */
+    virtual std::size_t getWorkerCount() const = 0;
+
+    /**
+     * @brief Run work on the pool, then pass its result to a continuation on the main thread
+     * @param work Callable run on the worker pool
+     * @param continuation Callable run on the main thread, with work's result if it has one
+     */
+    template <typename Work, typename Continuation>
+    void postThen(Work work, Continuation continuation)
+    {
+        using Result = std::decay_t<std::invoke_result_t<Work&>>;
+        auto callables
+            = std::make_shared<std::pair<Work, Continuation>>(std::move(work), std::move(continuation));
+        post([this, callables] {
+            if constexpr (std::is_void_v<Result>) {
+                callables->first();
+                postToMain([callables] { callables->second(); });
+            } else {
+                auto result = std::make_shared<Result>(callables->first());
+                postToMain([callables, result] { callables->second(std::move(*result)); });
+            }
+        });
+    }
+};
+
+} // namespace PluginSDK::Scheduler
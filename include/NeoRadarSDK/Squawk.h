@@ -1,7 +1,10 @@
 #pragma once
 #include "Aircraft.h"
 #include "Flightplan.h"
+#include <chrono>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -10,6 +13,30 @@ namespace PluginSDK::Squawk {
 class RegistrationToken;
 class SquawkProviderInterface;
 
+/**
+ * @struct SquawkRequest
+ * @brief One aircraft in a batch squawk generation
+ */
+struct SquawkRequest {
+    std::string callsign;
+    // Valid for the duration of the provider call only
+    const Aircraft::Aircraft* aircraft = nullptr;
+    const Flightplan::Flightplan* flightplan = nullptr;
+};
+
+/**
+ * @struct SquawkRangeReservation
+ * @brief Named block of codes reserved in the host's squawk pool
+ */
+struct SquawkRangeReservation {
+    std::string name;
+    // First and last code of the range, inclusive (4 octal digits)
+    std::string firstCode;
+    std::string lastCode;
+    // FIR or airport ICAO the range belongs to, empty for shared ranges (e.g. VFR)
+    std::string owner;
+};
+
 /**
  * @interface SquawkAPI
  * @brief Interface for squawk operations
@@ -46,6 +73,99 @@ public:
      * @return List of provider names
      */
     virtual std::vector<std::string> getAvailableProviders() = 0;
+
+    /**
+     * @brief Get available squawk providers into a caller-owned vector
+     * @param out Replaced with the provider names, reusing its capacity and string buffers
+     */
+    virtual void getAvailableProviders(std::vector<std::string>& out) = 0;
+
+    /**
+     * @brief Get available squawk providers into memory from the caller's resource
+     * @param out Replaced with the provider names; the vector and the strings
+     * allocate from the vector's resource
+     */
+    virtual void getAvailableProviders(std::pmr::vector<std::pmr::string>& out) = 0;
+
+    /**
+     * @brief Reserve a named range in the squawk pool
+     * @param reservation Range to reserve
+     * @return True if successful, false if invalid or overlapping another range
+     */
+    virtual bool reserveRange(const SquawkRangeReservation& reservation) = 0;
+
+    /**
+     * @brief Release a named range
+     * @param name Range name
+     * @return True if the range existed
+     */
+    virtual bool releaseRange(const std::string& name) = 0;
+
+    /**
+     * @brief Allocate the next free code of a range
+     * @param rangeName Range to allocate from
+     * @param callsign Aircraft the code is allocated to, or empty for an anonymous allocation
+     * @return Allocated code, or std::nullopt if the range is exhausted
+     *
+     * @note Codes in use on the network (beacon code changes and assigned squawks)
+     *       and codes still cooling down after release are skipped. An aircraft that
+     *       already holds an allocation from the range gets the same code again; its
+     *       allocation is released when it disconnects.
+     */
+    virtual std::optional<std::string> allocateCode(
+        const std::string& rangeName, const std::string& callsign)
+        = 0;
+
+    /**
+     * @brief Return a code to the pool; it stays unavailable for the cooldown period
+     * @param code Code to release
+     */
+    virtual void releaseCode(const std::string& code) = 0;
+
+    /**
+     * @brief Check whether a code is in use or cooling down
+     * @param code Code to check (4 octal digits)
+     * @return True if the code cannot be allocated
+     */
+    virtual bool isCodeInUse(const std::string& code) = 0;
+
+    /**
+     * @brief Set how long released codes are held before reuse
+     * @param cooldown Hold duration
+     */
+    virtual void setReleaseCooldown(std::chrono::seconds cooldown) = 0;
+
+    /**
+     * @brief Get the aircraft currently squawking a code
+     * @param code Code to look up
+     * @return Callsigns squawking the code
+     */
+    virtual std::vector<std::string> getCallsignsBySquawk(const std::string& code) = 0;
+
+    /**
+     * @brief Get every code currently squawked by more than one aircraft
+     * @return List of duplicate codes
+     */
+    virtual std::vector<std::string> getDuplicateSquawks() = 0;
+
+    /**
+     * @brief Generate and assign codes for several aircraft without blocking
+     * @param callsigns Aircraft to assign codes to
+     *
+     * @note Providers run on a host worker thread. Each assignment is reported
+     *       through SquawkAssignedEvent.
+     */
+    virtual void assignSquawks(const std::vector<std::string>& callsigns) = 0;
+
+    /**
+     * @brief Set the time a provider has to answer before the host falls back
+     * to the next provider by priority
+     * @param deadline Deadline per provider call; zero waits without limit
+     *
+     * @note Callsigns a provider leaves empty or answers with an invalid code
+     *       also fall back. An answer arriving after the deadline is discarded.
+     */
+    virtual void setProviderDeadline(std::chrono::milliseconds deadline) = 0;
 };
 
 /**
@@ -85,6 +205,26 @@ public:
         const Aircraft::Aircraft& aircraft, const Flightplan::Flightplan& flightplan)
         = 0;
 
+    /**
+     * @brief Generate squawk codes for several aircraft at once
+     * @param requests Aircraft to generate codes for
+     * @return One code per request, in order (empty string if none could be generated)
+     *
+     * @note May be called from a host worker thread. The default implementation
+     *       calls GenerateSquawk for each request.
+     */
+    virtual std::vector<std::string> GenerateSquawks(const std::vector<SquawkRequest>& requests)
+    {
+        std::vector<std::string> codes;
+        codes.reserve(requests.size());
+        for (const SquawkRequest& request : requests) {
+            codes.push_back(request.aircraft && request.flightplan
+                    ? GenerateSquawk(request.callsign, *request.aircraft, *request.flightplan)
+                    : std::string());
+        }
+        return codes;
+    }
+
     /**
      * @brief Get the provider's name
      * @return Provider name (must be unique within the system)
@@ -108,4 +248,16 @@ struct SquawkAssignedEvent {
     const char* providerName;
 };
 
+/**
+ * @struct DuplicateSquawkEvent
+ * @brief Event fired when a code gains a second holder, and again when the duplicate clears
+ */
+struct DuplicateSquawkEvent {
+    std::string squawk;
+    // Aircraft squawking the code after the change
+    std::vector<std::string> callsigns;
+    // False when the duplicate has cleared
+    bool isDuplicate;
+};
+
 } // namespace PluginSDK
@@ -1,6 +1,8 @@
 #pragma once
+#include "DataMap.h"
 #include <array>
-#include <map>
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -24,7 +26,41 @@ struct TagContext {
     std::string listId;
     std::optional<std::array<unsigned int, 3>> colour;
     std::optional<std::array<unsigned int, 3>> backgroundColour;
-    std::map<std::string, std::string> data;
+    DataMap data;
+};
+
+struct TagValueUpdate {
+    std::string tagId;
+    std::string callsign;
+    std::string value;
+    std::optional<std::array<unsigned int, 3>> colour;
+    std::optional<std::array<unsigned int, 3>> backgroundColour;
+};
+
+struct TagValueUpdateResult {
+    std::size_t applied = 0;
+    std::size_t unchanged = 0;
+    std::size_t failed = 0;
+};
+
+struct TagValueRequest {
+    std::string tagId;
+    std::string callsign;
+    std::string listId;
+};
+
+class TagValueProvider {
+public:
+    virtual ~TagValueProvider() = default;
+
+    /**
+     * @brief Compute values for the tags the host is about to display
+     * @param requests Visible tags without a cached value, batched once per frame
+     * @param outValues Values to display; one entry per request that could be computed
+     */
+    virtual void ProvideTagValues(
+        const std::vector<TagValueRequest>& requests, std::vector<TagValueUpdate>& outValues)
+        = 0;
 };
 
 struct TagActionEvent {
@@ -33,7 +69,7 @@ struct TagActionEvent {
     std::string callsign;
     int button;
     std::optional<std::string> userInput;
-    std::map<std::string, std::string> data;
+    DataMap data;
 };
 
 // Dropdown types
@@ -66,7 +102,7 @@ struct DropdownComponent {
     std::string id;
     DropdownComponentType type;
     std::string text;
-    std::map<std::string, std::string> data;
+    DataMap data;
     DropdownComponentStyle style;
     bool requiresInput = false;
     std::vector<DropdownComponent> children;
@@ -79,13 +115,68 @@ struct DropdownDefinition {
     std::vector<DropdownComponent> components;
 };
 
+struct VirtualScrollAreaDefinition {
+    int rowHeight = 20;
+    // Rows fetched beyond each edge of the visible range
+    std::size_t prefetchRows = 20;
+};
+
+struct DropdownItemRange {
+    std::string actionId;
+    std::string componentId;
+    std::string callsign;
+    std::size_t first = 0;
+    std::size_t count = 0;
+};
+
+class DropdownItemSource {
+public:
+    virtual ~DropdownItemSource() = default;
+
+    /**
+     * @brief Get the total number of rows in a virtualized scroll area
+     * @param actionId Action the dropdown is attached to
+     * @param componentId ScrollArea component ID
+     * @param callsign Aircraft the dropdown is shown for
+     * @return Row count
+     */
+    virtual std::size_t GetItemCount(const std::string& actionId,
+        const std::string& componentId, const std::string& callsign)
+        = 0;
+
+    /**
+     * @brief Build the rows of a range
+     * @param range Rows requested by the host (visible rows plus prefetch)
+     * @param outItems One component per row, in order
+     */
+    virtual void GetItems(
+        const DropdownItemRange& range, std::vector<DropdownComponent>& outItems)
+        = 0;
+};
+
+enum class DropdownPatchType { SetText, SetChecked, InsertChild, RemoveComponent };
+
+// DataMap key holding the state SetChecked writes, "true" or "false"
+inline constexpr DataKey DropdownCheckedKey { "checked" };
+
+struct DropdownPatch {
+    DropdownPatchType type;
+    // Target component; the parent component for InsertChild
+    std::string componentId;
+    std::string text;
+    bool checked = false;
+    std::optional<DropdownComponent> child;
+    // Insert position within the parent's children, appended when unset
+    std::optional<std::size_t> index;
+};
+
 struct DropdownActionEvent {
     std::string actionId;
     std::string componentId;
     std::string tagId;
     std::string callsign;
     std::optional<std::string> userInput;
-    std::map<std::string, std::string> data;
+    DataMap data;
 };
 
 class TagInterface {
@@ -94,18 +185,114 @@ public:
 
     virtual std::string RegisterTagItem(const TagItemDefinition& definition) = 0;
     virtual std::string RegisterTagAction(const TagActionDefinition& definition) = 0;
+
+    /**
+     * @brief Register the name of a DataMap key, typically once at startup
+     * @param name Key name
+     * @return True if registered, false if it collides with a different name
+     */
+    virtual bool RegisterDataKey(const std::string& name) = 0;
+
+    /**
+     * @brief Get the registered name of a DataMap key
+     * @param key Interned key
+     * @return Key name, or empty string if the key was never registered
+     */
+    virtual std::string GetDataKeyName(DataKey key) const = 0;
     virtual bool UpdateTagValue(
         const std::string& tagId, const std::string& value, const TagContext& context)
         = 0;
 
+    /**
+     * @brief Update many tag values in a single call
+     * @param updates Flat list of tag updates, applied in order
+     * @return Counts of applied, unchanged and failed updates
+     *
+     * @note Updates whose value and colours match what the host already displays
+     *       for that tag and aircraft are dropped before any re-render and counted
+     *       as unchanged.
+     */
+    virtual TagValueUpdateResult UpdateTagValues(const std::vector<TagValueUpdate>& updates)
+        = 0;
+
+    /**
+     * @brief Make a tag item pull-based instead of push-based
+     * @param tagId Tag item ID returned by RegisterTagItem
+     * @param provider Provider queried for visible tags only
+     * @return True if successful
+     *
+     * @note Provided values are cached per aircraft until invalidated.
+     */
+    virtual bool SetTagValueProvider(
+        const std::string& tagId, std::shared_ptr<TagValueProvider> provider)
+        = 0;
+    virtual bool RemoveTagValueProvider(const std::string& tagId) = 0;
+
+    /**
+     * @brief Drop the cached value of a provider-backed tag for one aircraft
+     * @param tagId Tag item ID
+     * @param callsign Aircraft callsign
+     */
+    virtual void InvalidateTagValue(const std::string& tagId, const std::string& callsign)
+        = 0;
+
+    /**
+     * @brief Drop the cached values of every provider-backed tag for one aircraft
+     * @param callsign Aircraft callsign
+     */
+    virtual void InvalidateTagValues(const std::string& callsign) = 0;
+
     virtual bool SetActionDropdown(
         const std::string& actionId, const DropdownDefinition& dropdown)
         = 0;
     virtual bool UpdateActionDropdown(
         const std::string& actionId, const DropdownDefinition& dropdown)
         = 0;
+    /**
+     * @brief Apply incremental changes to an existing dropdown
+     * @param actionId Action the dropdown is attached to
+     * @param patches Changes addressed by component ID, applied in order
+     * @return Number of patches applied, 0 if the action has no dropdown
+     *
+     * Patches are not atomic: one whose component ID is unknown, or an
+     * InsertChild without a child, is skipped and the following patches are
+     * still applied. Compare the result with patches.size() to detect that.
+     *
+     * @note Only the patched components are diffed and re-rendered by the host.
+     */
+    virtual std::size_t PatchActionDropdown(
+        const std::string& actionId, const std::vector<DropdownPatch>& patches)
+        = 0;
+    /**
+     * @brief Virtualize the content of a ScrollArea component
+     * @param actionId Action the dropdown is attached to
+     * @param componentId ScrollArea component ID; its children are ignored
+     * @param definition Row geometry and prefetch window
+     * @param source Source queried for the rows in view only
+     * @return True if successful
+     */
+    virtual bool SetScrollAreaItemSource(const std::string& actionId,
+        const std::string& componentId, const VirtualScrollAreaDefinition& definition,
+        std::shared_ptr<DropdownItemSource> source)
+        = 0;
+
+    /**
+     * @brief Discard fetched rows and the row count of a virtualized ScrollArea
+     * @param actionId Action the dropdown is attached to
+     * @param componentId ScrollArea component ID
+     */
+    virtual void InvalidateScrollAreaItems(
+        const std::string& actionId, const std::string& componentId)
+        = 0;
     virtual bool RemoveActionDropdown(const std::string& actionId) = 0;
 
+    /**
+     * @brief Get the dropdown of an action as the host shows it
+     * @param actionId Action the dropdown is attached to
+     * @param outDropdown Dropdown; virtualized ScrollArea components hold the
+     * rows last fetched from their source as children
+     * @return True if the action has a dropdown
+     */
     virtual bool GetDropdownForAction(
         const std::string& actionId, DropdownDefinition& outDropdown) const
         = 0;
@@ -0,0 +1,546 @@
+#include "NeoRadarSDK/Recording.h"
+#include "RecordingFormat.h"
+
+#include <array>
+#include <utility>
+
+namespace PluginSDK::Recording {
+
+using namespace detail;
+
+RecordingPlugin::RecordingPlugin(std::unique_ptr<BasePlugin> plugin, std::filesystem::path path,
+    std::chrono::milliseconds snapshotInterval)
+    : m_plugin(std::move(plugin))
+    , m_path(std::move(path))
+    , m_snapshotInterval(snapshotInterval)
+{
+}
+
+RecordingPlugin::~RecordingPlugin() = default;
+
+void RecordingPlugin::Initialize(
+    const PluginMetadata& metadata, CoreAPI* coreAPI, ClientInformation info)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_coreAPI = coreAPI;
+        m_start = std::chrono::steady_clock::now();
+        m_lastSnapshot.reset();
+
+        m_file.open(m_path, std::ios::binary | std::ios::trunc);
+        if (m_file) {
+            m_buffer.clear();
+            Encoder header(m_buffer);
+            header(metadata, info);
+
+            std::string fileHeader(Magic, sizeof(Magic));
+            Logger::writeLittleEndian(fileHeader, Version);
+            Logger::writeLittleEndian(fileHeader, std::uint16_t(0));
+            Logger::writeLittleEndian(fileHeader, static_cast<std::uint32_t>(m_buffer.size()));
+            m_file.write(fileHeader.data(), fileHeader.size());
+            m_file.write(m_buffer.data(), m_buffer.size());
+        } else if (coreAPI) {
+            coreAPI->logger().error("Cannot open recording file " + m_path.string());
+        }
+    }
+
+    m_plugin->Initialize(metadata, coreAPI, std::move(info));
+    m_forwarded = m_plugin->GetEventSubscriptions();
+}
+
+void RecordingPlugin::Shutdown()
+{
+    m_plugin->Shutdown();
+
+    std::lock_guard lock(m_mutex);
+    if (m_file.is_open()) {
+        m_buffer.clear();
+        writeRecord(RecordKind::End, EventType::Count);
+        m_file.close();
+    }
+}
+
+PluginMetadata RecordingPlugin::GetMetadata() const { return m_plugin->GetMetadata(); }
+
+Dispatch::DispatchOptions RecordingPlugin::GetDispatchOptions() const
+{
+    return m_plugin->GetDispatchOptions();
+}
+
+// Batches then only hold events the wrapped plugin subscribes to
+EventMask RecordingPlugin::GetBatchedEvents() const
+{
+    return m_plugin->GetBatchedEvents() & m_plugin->GetEventSubscriptions();
+}
+
+template <typename T> void RecordingPlugin::record(EventType type, const T& event)
+{
+    std::lock_guard lock(m_mutex);
+    if (!m_file.is_open()) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (m_coreAPI && (!m_lastSnapshot || now - *m_lastSnapshot >= m_snapshotInterval)) {
+        Snapshot snapshot;
+        snapshot.aircraft = m_coreAPI->aircraft().getAll();
+        snapshot.flightplans = m_coreAPI->flightplan().getAll();
+        snapshot.controllers = m_coreAPI->controller().getAll();
+        snapshot.controllerData = m_coreAPI->controllerData().getAll();
+        snapshot.airports = m_coreAPI->airport().getConfigurations();
+        snapshot.connection = m_coreAPI->fsd().getConnection();
+
+        m_buffer.clear();
+        Encoder encoder(m_buffer);
+        encoder(snapshot);
+        writeRecord(RecordKind::Snapshot, EventType::Count);
+        m_lastSnapshot = now;
+    }
+
+    m_buffer.clear();
+    Encoder encoder(m_buffer);
+    encoder(event);
+    writeRecord(RecordKind::Event, type);
+}
+
+void RecordingPlugin::writeRecord(RecordKind kind, EventType type)
+{
+    const auto timestamp = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start)
+            .count());
+
+    std::string recordHeader;
+    Logger::writeLittleEndian(recordHeader, kind);
+    Logger::writeLittleEndian(recordHeader, timestamp);
+    Logger::writeLittleEndian(recordHeader, type);
+    Logger::writeLittleEndian(recordHeader, static_cast<std::uint32_t>(m_buffer.size()));
+    m_file.write(recordHeader.data(), recordHeader.size());
+    m_file.write(m_buffer.data(), m_buffer.size());
+}
+
+// Records the event, then forwards it to the wrapped plugin if it subscribes to it
+#define NEORADAR_RECORDED_HANDLER(Name, EventStruct)                                      \
+    void RecordingPlugin::On##Name(const EventStruct* event)                              \
+    {                                                                                     \
+        record(EventType::Name, *event);                                                  \
+        if (m_forwarded.test(EventType::Name)) {                                          \
+            m_plugin->On##Name(event);                                                    \
+        }                                                                                 \
+    }
+
+NEORADAR_RECORDED_HANDLER(AircraftConnected, Aircraft::AircraftConnectedEvent)
+NEORADAR_RECORDED_HANDLER(AircraftDisconnected, Aircraft::AircraftDisconnectedEvent)
+NEORADAR_RECORDED_HANDLER(PositionUpdate, Aircraft::PositionUpdateEvent)
+
+NEORADAR_RECORDED_HANDLER(AirportAdded, Airport::AirportAddedEvent)
+NEORADAR_RECORDED_HANDLER(AirportRemoved, Airport::AirportRemovedEvent)
+NEORADAR_RECORDED_HANDLER(AirportStatusChanged, Airport::AirportStatusChangedEvent)
+NEORADAR_RECORDED_HANDLER(RunwayStatusChanged, Airport::RunwayStatusChangedEvent)
+NEORADAR_RECORDED_HANDLER(
+    AirportConfigurationsUpdated, Airport::AirportConfigurationsUpdatedEvent)
+
+NEORADAR_RECORDED_HANDLER(AtcPositionUpdate, Controller::AtcPositionUpdateEvent)
+NEORADAR_RECORDED_HANDLER(AtisLinesUpdate, Controller::AtisLinesUpdateEvent)
+NEORADAR_RECORDED_HANDLER(CapabilitiesUpdate, Controller::CapabilitiesUpdateEvent)
+NEORADAR_RECORDED_HANDLER(ControllerDisconnected, Controller::ControllerDisconnectedEvent)
+NEORADAR_RECORDED_HANDLER(ControllerConnected, Controller::ControllerConnectedEvent)
+NEORADAR_RECORDED_HANDLER(IsControllerATC, Controller::IsControllerATCEvent)
+
+NEORADAR_RECORDED_HANDLER(ControllerDataUpdated, ControllerData::ControllerDataUpdatedEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftBeaconCodeChanged, ControllerData::AircraftBeaconCodeChangedEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftHandoffCancelled, ControllerData::AircraftHandoffCancelledEvent)
+NEORADAR_RECORDED_HANDLER(AircraftOwnedByChanged, ControllerData::AircraftOwnedByChangedEvent)
+NEORADAR_RECORDED_HANDLER(AircraftHandoffRejected, ControllerData::AircraftHandoffRejectedEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftTerminatedTracking, ControllerData::AircraftTerminatedTrackingEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftInitiatedTracking, ControllerData::AircraftInitiatedTrackingEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftTemporaryAltitudeChanged, ControllerData::AircraftTemporaryAltitudeChangedEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftCDMStatusChanged, ControllerData::AircraftCDMStatusChangedEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftScratchpadUpdated, ControllerData::AircraftScratchpadUpdatedEvent)
+NEORADAR_RECORDED_HANDLER(AircraftHeadingChanged, ControllerData::AircraftHeadingChangedEvent)
+NEORADAR_RECORDED_HANDLER(
+    AircraftAssignedSpeedChanged, ControllerData::AircraftAssignedSpeedChangedEvent)
+
+NEORADAR_RECORDED_HANDLER(FlightplanUpdated, Flightplan::FlightplanUpdatedEvent)
+NEORADAR_RECORDED_HANDLER(FlightplanRemoved, Flightplan::FlightplanRemovedEvent)
+NEORADAR_RECORDED_HANDLER(FlightplanVoiceTypeChanged, Flightplan::FlightplanVoiceTypeChangedEvent)
+NEORADAR_RECORDED_HANDLER(FlightplanRouteChanged, Flightplan::FlightplanRouteChangedEvent)
+
+NEORADAR_RECORDED_HANDLER(FsdError, Fsd::FsdErrorEvent)
+NEORADAR_RECORDED_HANDLER(FsdConnectionStateChange, Fsd::FsdConnectionStateChangeEvent)
+NEORADAR_RECORDED_HANDLER(FsdConnected, Fsd::FsdConnectedEvent)
+NEORADAR_RECORDED_HANDLER(FsdDisconnected, Fsd::FsdDisconnectedEvent)
+NEORADAR_RECORDED_HANDLER(FsdConnectionModelUpdated, Fsd::FsdConnectionModelUpdatedEvent)
+
+NEORADAR_RECORDED_HANDLER(FlightplanMessageReceived, Chat::FlightplanMessageReceivedEvent)
+NEORADAR_RECORDED_HANDLER(ATISInfoMessageReceived, Chat::ATISInfoMessageReceivedEvent)
+NEORADAR_RECORDED_HANDLER(FrequencyMessageReceived, Chat::FrequencyMessageReceivedEvent)
+NEORADAR_RECORDED_HANDLER(PrivateMessageReceived, Chat::PrivateMessageReceivedEvent)
+NEORADAR_RECORDED_HANDLER(BroadcastMessageReceived, Chat::BroadcastMessageReceivedEvent)
+NEORADAR_RECORDED_HANDLER(SupervisorMessageReceived, Chat::SupervisorMessageReceivedEvent)
+NEORADAR_RECORDED_HANDLER(ServerMessageReceived, Chat::ServerMessageReceivedEvent)
+NEORADAR_RECORDED_HANDLER(AtcMessageReceived, Chat::AtcMessageReceivedEvent)
+
+NEORADAR_RECORDED_HANDLER(SquawkAssigned, Squawk::SquawkAssignedEvent)
+NEORADAR_RECORDED_HANDLER(DuplicateSquawk, Squawk::DuplicateSquawkEvent)
+
+NEORADAR_RECORDED_HANDLER(TagAction, Tag::TagActionEvent)
+NEORADAR_RECORDED_HANDLER(TagDropdownAction, Tag::DropdownActionEvent)
+
+#undef NEORADAR_RECORDED_HANDLER
+
+bool RecordingPlugin::OnTagShowDropdown(const std::string& actionId, const std::string& callsign)
+{
+    record(EventType::TagShowDropdown, std::make_pair(actionId, callsign));
+    return m_forwarded.test(EventType::TagShowDropdown)
+        && m_plugin->OnTagShowDropdown(actionId, callsign);
+}
+
+void RecordingPlugin::OnEventBatch(const EventBatch& batch)
+{
+    for (const BatchedEvent& event : batch) {
+        event.visit([&](const auto& payload) { record(event.type, payload); });
+    }
+    m_plugin->OnEventBatch(batch);
+}
+
+namespace {
+
+template <typename T> std::string encodeValue(const T& value)
+{
+    std::string buffer;
+    Encoder encoder(buffer);
+    encoder(value);
+    return buffer;
+}
+
+} // namespace
+
+std::string encode(const Aircraft::Aircraft& aircraft) { return encodeValue(aircraft); }
+std::string encode(const Flightplan::Flightplan& flightplan) { return encodeValue(flightplan); }
+std::string encode(const Controller::Controller& controller) { return encodeValue(controller); }
+std::string encode(const ControllerData::ControllerDataModel& controllerData)
+{
+    return encodeValue(controllerData);
+}
+std::string encode(const Airport::AirportConfig& airport) { return encodeValue(airport); }
+
+namespace {
+
+class DecodedEventBase : public RecordedEvent {
+public:
+    virtual bool decode(Decoder& decoder) = 0;
+    virtual std::unique_ptr<RecordedEvent> clone() const = 0;
+};
+
+template <EventType Type, typename T, void (BasePlugin::*Handler)(const T*)>
+class DecodedEvent : public DecodedEventBase {
+public:
+    bool decode(Decoder& decoder) override
+    {
+        decoder(m_event);
+        return decoder.ok();
+    }
+    std::unique_ptr<RecordedEvent> clone() const override
+    {
+        return std::make_unique<DecodedEvent>(*this);
+    }
+    EventType type() const override { return Type; }
+    void dispatch(BasePlugin& plugin) const override { (plugin.*Handler)(&m_event); }
+    void* data() override { return &m_event; }
+    const void* data() const override { return &m_event; }
+
+private:
+    T m_event {};
+};
+
+class DecodedSquawkAssigned : public DecodedEventBase {
+public:
+    DecodedSquawkAssigned() = default;
+    DecodedSquawkAssigned(const DecodedSquawkAssigned& other)
+        : m_record(other.m_record)
+    {
+        updatePointers();
+    }
+
+    bool decode(Decoder& decoder) override
+    {
+        decoder(m_record);
+        updatePointers();
+        return decoder.ok();
+    }
+    std::unique_ptr<RecordedEvent> clone() const override
+    {
+        return std::make_unique<DecodedSquawkAssigned>(*this);
+    }
+    EventType type() const override { return EventType::SquawkAssigned; }
+    void dispatch(BasePlugin& plugin) const override { plugin.OnSquawkAssigned(&m_record.event); }
+    void* data() override { return &m_record.event; }
+    const void* data() const override { return &m_record.event; }
+
+private:
+    // The event points into the record's strings
+    void updatePointers()
+    {
+        m_record.event = { m_record.callsign.c_str(), m_record.squawk.c_str(),
+            m_record.providerName.c_str() };
+    }
+
+    SquawkAssignedRecord m_record;
+};
+
+class DecodedTagShowDropdown : public DecodedEventBase {
+public:
+    bool decode(Decoder& decoder) override
+    {
+        decoder(m_arguments);
+        return decoder.ok();
+    }
+    std::unique_ptr<RecordedEvent> clone() const override
+    {
+        return std::make_unique<DecodedTagShowDropdown>(*this);
+    }
+    EventType type() const override { return EventType::TagShowDropdown; }
+    void dispatch(BasePlugin& plugin) const override
+    {
+        plugin.OnTagShowDropdown(m_arguments.first, m_arguments.second);
+    }
+    void* data() override { return &m_arguments; }
+    const void* data() const override { return &m_arguments; }
+
+private:
+    std::pair<std::string, std::string> m_arguments;
+};
+
+std::unique_ptr<DecodedEventBase> makeDecodedEvent(EventType type)
+{
+#define NEORADAR_DECODED_EVENT(Name, EventStruct)                                         \
+    case EventType::Name:                                                                 \
+        return std::make_unique<                                                          \
+            DecodedEvent<EventType::Name, EventStruct, &BasePlugin::On##Name>>();
+
+    switch (type) {
+        NEORADAR_DECODED_EVENT(AircraftConnected, Aircraft::AircraftConnectedEvent)
+        NEORADAR_DECODED_EVENT(AircraftDisconnected, Aircraft::AircraftDisconnectedEvent)
+        NEORADAR_DECODED_EVENT(PositionUpdate, Aircraft::PositionUpdateEvent)
+        NEORADAR_DECODED_EVENT(AirportAdded, Airport::AirportAddedEvent)
+        NEORADAR_DECODED_EVENT(AirportRemoved, Airport::AirportRemovedEvent)
+        NEORADAR_DECODED_EVENT(AirportStatusChanged, Airport::AirportStatusChangedEvent)
+        NEORADAR_DECODED_EVENT(RunwayStatusChanged, Airport::RunwayStatusChangedEvent)
+        NEORADAR_DECODED_EVENT(
+            AirportConfigurationsUpdated, Airport::AirportConfigurationsUpdatedEvent)
+        NEORADAR_DECODED_EVENT(AtcPositionUpdate, Controller::AtcPositionUpdateEvent)
+        NEORADAR_DECODED_EVENT(AtisLinesUpdate, Controller::AtisLinesUpdateEvent)
+        NEORADAR_DECODED_EVENT(CapabilitiesUpdate, Controller::CapabilitiesUpdateEvent)
+        NEORADAR_DECODED_EVENT(ControllerDisconnected, Controller::ControllerDisconnectedEvent)
+        NEORADAR_DECODED_EVENT(ControllerConnected, Controller::ControllerConnectedEvent)
+        NEORADAR_DECODED_EVENT(IsControllerATC, Controller::IsControllerATCEvent)
+        NEORADAR_DECODED_EVENT(ControllerDataUpdated, ControllerData::ControllerDataUpdatedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftBeaconCodeChanged, ControllerData::AircraftBeaconCodeChangedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftHandoffCancelled, ControllerData::AircraftHandoffCancelledEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftOwnedByChanged, ControllerData::AircraftOwnedByChangedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftHandoffRejected, ControllerData::AircraftHandoffRejectedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftTerminatedTracking, ControllerData::AircraftTerminatedTrackingEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftInitiatedTracking, ControllerData::AircraftInitiatedTrackingEvent)
+        NEORADAR_DECODED_EVENT(AircraftTemporaryAltitudeChanged,
+            ControllerData::AircraftTemporaryAltitudeChangedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftCDMStatusChanged, ControllerData::AircraftCDMStatusChangedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftScratchpadUpdated, ControllerData::AircraftScratchpadUpdatedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftHeadingChanged, ControllerData::AircraftHeadingChangedEvent)
+        NEORADAR_DECODED_EVENT(
+            AircraftAssignedSpeedChanged, ControllerData::AircraftAssignedSpeedChangedEvent)
+        NEORADAR_DECODED_EVENT(FlightplanUpdated, Flightplan::FlightplanUpdatedEvent)
+        NEORADAR_DECODED_EVENT(FlightplanRemoved, Flightplan::FlightplanRemovedEvent)
+        NEORADAR_DECODED_EVENT(
+            FlightplanVoiceTypeChanged, Flightplan::FlightplanVoiceTypeChangedEvent)
+        NEORADAR_DECODED_EVENT(FlightplanRouteChanged, Flightplan::FlightplanRouteChangedEvent)
+        NEORADAR_DECODED_EVENT(FsdError, Fsd::FsdErrorEvent)
+        NEORADAR_DECODED_EVENT(FsdConnectionStateChange, Fsd::FsdConnectionStateChangeEvent)
+        NEORADAR_DECODED_EVENT(FsdConnected, Fsd::FsdConnectedEvent)
+        NEORADAR_DECODED_EVENT(FsdDisconnected, Fsd::FsdDisconnectedEvent)
+        NEORADAR_DECODED_EVENT(FsdConnectionModelUpdated, Fsd::FsdConnectionModelUpdatedEvent)
+        NEORADAR_DECODED_EVENT(FlightplanMessageReceived, Chat::FlightplanMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(ATISInfoMessageReceived, Chat::ATISInfoMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(FrequencyMessageReceived, Chat::FrequencyMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(PrivateMessageReceived, Chat::PrivateMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(BroadcastMessageReceived, Chat::BroadcastMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(SupervisorMessageReceived, Chat::SupervisorMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(ServerMessageReceived, Chat::ServerMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(AtcMessageReceived, Chat::AtcMessageReceivedEvent)
+        NEORADAR_DECODED_EVENT(DuplicateSquawk, Squawk::DuplicateSquawkEvent)
+        NEORADAR_DECODED_EVENT(TagAction, Tag::TagActionEvent)
+        NEORADAR_DECODED_EVENT(TagDropdownAction, Tag::DropdownActionEvent)
+    case EventType::SquawkAssigned:
+        return std::make_unique<DecodedSquawkAssigned>();
+    case EventType::TagShowDropdown:
+        return std::make_unique<DecodedTagShowDropdown>();
+    case EventType::Count:
+        break;
+    }
+    return nullptr;
+
+#undef NEORADAR_DECODED_EVENT
+}
+
+} // namespace
+
+struct RecordingReader::Impl {
+    std::ifstream file;
+    PluginMetadata metadata;
+    ClientInformation clientInformation;
+    std::vector<char> payload;
+
+    RecordKind kind = RecordKind::End;
+    EventType eventType = EventType::Count;
+    std::chrono::nanoseconds timestamp { 0 };
+    Snapshot snapshot;
+
+    // One decoded event per type, reused so strings and vectors keep their capacity
+    std::array<std::unique_ptr<DecodedEventBase>, static_cast<std::size_t>(EventType::Count)>
+        events;
+    const DecodedEventBase* current = nullptr;
+
+    template <typename T> bool read(T& value)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+            char bytes[sizeof(T)];
+            if (!file.read(bytes, sizeof(T))) {
+                return false;
+            }
+            value = Logger::readLittleEndian<T>(bytes);
+            return true;
+        } else {
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+    }
+
+    bool readPayload(std::uint32_t size)
+    {
+        payload.resize(size);
+        return size == 0 || static_cast<bool>(file.read(payload.data(), size));
+    }
+};
+
+RecordingReader::RecordingReader()
+    : m_impl(std::make_unique<Impl>())
+{
+}
+
+RecordingReader::~RecordingReader() = default;
+
+bool RecordingReader::open(const std::filesystem::path& path)
+{
+    Impl& impl = *m_impl;
+    impl.file.open(path, std::ios::binary);
+    if (!impl.file) {
+        return false;
+    }
+
+    char magic[sizeof(Magic)] = {};
+    std::uint16_t version = 0;
+    std::uint16_t reserved = 0;
+    std::uint32_t size = 0;
+    if (!impl.read(magic) || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+        || !impl.read(version) || version != Version || !impl.read(reserved)
+        || !impl.read(size) || !impl.readPayload(size)) {
+        return false;
+    }
+
+    Decoder decoder(impl.payload.data(), impl.payload.size());
+    decoder(impl.metadata, impl.clientInformation);
+    return decoder.ok();
+}
+
+const PluginMetadata& RecordingReader::metadata() const { return m_impl->metadata; }
+
+const ClientInformation& RecordingReader::clientInformation() const
+{
+    return m_impl->clientInformation;
+}
+
+bool RecordingReader::next()
+{
+    Impl& impl = *m_impl;
+    impl.current = nullptr;
+
+    std::uint64_t timestamp = 0;
+    std::uint32_t size = 0;
+    if (!impl.read(impl.kind) || impl.kind == RecordKind::End || !impl.read(timestamp)
+        || !impl.read(impl.eventType) || !impl.read(size) || !impl.readPayload(size)) {
+        impl.kind = RecordKind::End;
+        return false;
+    }
+    impl.timestamp = std::chrono::nanoseconds(timestamp);
+
+    Decoder decoder(impl.payload.data(), impl.payload.size());
+    if (impl.kind == RecordKind::Snapshot) {
+        decoder(impl.snapshot);
+        return decoder.ok();
+    }
+    if (impl.kind != RecordKind::Event || impl.eventType >= EventType::Count) {
+        return false;
+    }
+
+    auto& event = impl.events[static_cast<std::size_t>(impl.eventType)];
+    if (!event) {
+        event = makeDecodedEvent(impl.eventType);
+    }
+    if (!event->decode(decoder)) {
+        return false;
+    }
+    impl.current = event.get();
+    return true;
+}
+
+RecordKind RecordingReader::kind() const { return m_impl->kind; }
+
+EventType RecordingReader::eventType() const { return m_impl->eventType; }
+
+std::chrono::nanoseconds RecordingReader::timestamp() const { return m_impl->timestamp; }
+
+const Snapshot& RecordingReader::snapshot() const { return m_impl->snapshot; }
+
+const void* RecordingReader::event() const
+{
+    return m_impl->current ? m_impl->current->data() : nullptr;
+}
+
+std::unique_ptr<RecordedEvent> RecordingReader::copyEvent() const
+{
+    return m_impl->current ? m_impl->current->clone() : nullptr;
+}
+
+std::unique_ptr<RecordedEvent> RecordingReader::takeEvent()
+{
+    Impl& impl = *m_impl;
+    if (!impl.current) {
+        return nullptr;
+    }
+    impl.current = nullptr;
+    return std::move(impl.events[static_cast<std::size_t>(impl.eventType)]);
+}
+
+void RecordingReader::dispatch(BasePlugin& plugin) const
+{
+    if (m_impl->current) {
+        m_impl->current->dispatch(plugin);
+    }
+}
+
+} // namespace PluginSDK::Recording
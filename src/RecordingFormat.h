@@ -0,0 +1,329 @@
+#pragma once
+#include "NeoRadarSDK/BinaryLog.h"
+#include "NeoRadarSDK/Recording.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Binary layout of recording files (all integers little-endian)
+//
+// File header:
+//   char[4] magic "NRRC", u16 version, u16 reserved,
+//   u32 size + encoded PluginMetadata and ClientInformation
+//
+// Records:
+//   u8 RecordKind, u64 timestamp (ns since Initialize), u8 EventType,
+//   u32 payload size, payload
+//
+// Payloads are the encoded event struct or Snapshot. Strings are a u32 length
+// followed by bytes, optionals a u8 presence flag, vectors a u32 count.
+
+namespace PluginSDK::Recording::detail {
+
+inline constexpr char Magic[4] = { 'N', 'R', 'R', 'C' };
+inline constexpr std::uint16_t Version = 1;
+
+template <typename T> struct IsOptional : std::false_type { };
+template <typename T> struct IsOptional<std::optional<T>> : std::true_type { };
+template <typename T> struct IsVector : std::false_type { };
+template <typename T> struct IsVector<std::vector<T>> : std::true_type { };
+template <typename T> struct IsArray : std::false_type { };
+template <typename T, std::size_t N> struct IsArray<std::array<T, N>> : std::true_type { };
+template <typename T> struct IsPair : std::false_type { };
+template <typename A, typename B> struct IsPair<std::pair<A, B>> : std::true_type { };
+
+class Encoder {
+public:
+    explicit Encoder(std::string& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    template <typename... Ts> void operator()(const Ts&... values) { (write(values), ...); }
+
+    template <typename T> void writeRaw(const T& value)
+    {
+        Logger::writeLittleEndian(m_buffer, value);
+    }
+
+    void writeString(const char* data, std::size_t size)
+    {
+        writeRaw(static_cast<std::uint32_t>(size));
+        m_buffer.append(data, size);
+    }
+
+private:
+    template <typename T> void write(const T& value)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+            writeRaw(value);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            writeString(value.data(), value.size());
+        } else if constexpr (std::is_same_v<T, const char*>) {
+            writeString(value ? value : "", value ? std::strlen(value) : 0);
+        } else if constexpr (std::is_same_v<T, std::filesystem::path>) {
+            write(value.string());
+        } else if constexpr (std::is_same_v<T, DataMap>) {
+            writeRaw(static_cast<std::uint32_t>(value.size()));
+            for (const DataMap::Entry& entry : value) {
+                writeRaw(entry.first.id);
+                write(entry.second);
+            }
+        } else if constexpr (IsOptional<T>::value) {
+            writeRaw(static_cast<std::uint8_t>(value.has_value()));
+            if (value) {
+                write(*value);
+            }
+        } else if constexpr (IsVector<T>::value) {
+            writeRaw(static_cast<std::uint32_t>(value.size()));
+            for (const auto& element : value) {
+                write(element);
+            }
+        } else if constexpr (IsArray<T>::value) {
+            for (const auto& element : value) {
+                write(element);
+            }
+        } else if constexpr (IsPair<T>::value) {
+            write(value.first);
+            write(value.second);
+        } else {
+            describe(*this, value);
+        }
+    }
+
+    std::string& m_buffer;
+};
+
+class Decoder {
+public:
+    Decoder(const char* data, std::size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    template <typename... Ts> void operator()(Ts&... values) { (read(values), ...); }
+
+    bool ok() const { return !m_failed; }
+
+    template <typename T> void readRaw(T& value)
+    {
+        if (m_failed || m_size - m_offset < sizeof(T)) {
+            m_failed = true;
+            return;
+        }
+        value = Logger::readLittleEndian<T>(m_data + m_offset);
+        m_offset += sizeof(T);
+    }
+
+private:
+    std::uint32_t readCount()
+    {
+        std::uint32_t count = 0;
+        readRaw(count);
+        // Every element takes at least one byte, which bounds corrupted counts
+        if (count > m_size - m_offset) {
+            m_failed = true;
+            return 0;
+        }
+        return count;
+    }
+
+    template <typename T> void read(T& value)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+            readRaw(value);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            const std::uint32_t size = readCount();
+            if (!m_failed) {
+                value.assign(m_data + m_offset, size);
+                m_offset += size;
+            }
+        } else if constexpr (std::is_same_v<T, std::filesystem::path>) {
+            std::string text;
+            read(text);
+            value = text;
+        } else if constexpr (std::is_same_v<T, DataMap>) {
+            value.clear();
+            const std::uint32_t count = readCount();
+            for (std::uint32_t i = 0; i < count && !m_failed; ++i) {
+                DataKey key;
+                std::string entry;
+                readRaw(key.id);
+                read(entry);
+                value.set(key, std::move(entry));
+            }
+        } else if constexpr (IsOptional<T>::value) {
+            std::uint8_t present = 0;
+            readRaw(present);
+            if (present && !m_failed) {
+                value.emplace();
+                read(*value);
+            } else {
+                value.reset();
+            }
+        } else if constexpr (IsVector<T>::value) {
+            const std::uint32_t count = readCount();
+            value.resize(count);
+            for (auto& element : value) {
+                read(element);
+            }
+        } else if constexpr (IsArray<T>::value) {
+            for (auto& element : value) {
+                read(element);
+            }
+        } else if constexpr (IsPair<T>::value) {
+            read(value.first);
+            read(value.second);
+        } else {
+            describe(*this, value);
+        }
+    }
+
+    const char* m_data;
+    std::size_t m_size;
+    std::size_t m_offset = 0;
+    bool m_failed = false;
+};
+
+// Lists the serialized fields of a struct, for both encoding and decoding
+#define NEORADAR_RECORDING_FIELDS(Type, ...)                                             \
+    template <typename Archive> void describe(Archive& ar, const Type& v) { ar(__VA_ARGS__); } \
+    template <typename Archive> void describe(Archive& ar, Type& v) { ar(__VA_ARGS__); }
+
+NEORADAR_RECORDING_FIELDS(PluginMetadata, v.name, v.version, v.author)
+NEORADAR_RECORDING_FIELDS(ClientInformation, v.clientName, v.clientVersion, v.fdpsVersion,
+    v.combinedVersion, v.documentsPath)
+
+NEORADAR_RECORDING_FIELDS(Aircraft::Position, v.latitude, v.longitude, v.altitude, v.agl,
+    v.trueAltitude, v.pressureAltitude, v.groundSpeed, v.reportedHeading, v.trackHeading,
+    v.verticalSpeed, v.verticalTrend, v.pitch, v.bank, v.velX, v.velY, v.velZ, v.velH,
+    v.onGround, v.stopped, v.transponderMode, v.timestamp)
+NEORADAR_RECORDING_FIELDS(Aircraft::Aircraft, v.callsign, v.cid, v.name, v.position,
+    v.previousPositions, v.hasPilotDetails, v.isTimingOut, v.isReady,
+    v.lastPositionUpdateTime, v.squawk, v.transponderMode, v.pressureDifference)
+NEORADAR_RECORDING_FIELDS(Aircraft::AircraftConnectedEvent, v.callsign, v.cid)
+NEORADAR_RECORDING_FIELDS(Aircraft::AircraftDisconnectedEvent, v.callsign)
+NEORADAR_RECORDING_FIELDS(Aircraft::PositionUpdateEvent, v.aircrafts)
+
+NEORADAR_RECORDING_FIELDS(Airport::AirportConfig, v.icao, v.arrRunways, v.depRunways, v.status)
+NEORADAR_RECORDING_FIELDS(Airport::AirportAddedEvent, v.icao)
+NEORADAR_RECORDING_FIELDS(Airport::AirportRemovedEvent, v.icao)
+NEORADAR_RECORDING_FIELDS(Airport::AirportStatusChangedEvent, v.icao, v.status)
+NEORADAR_RECORDING_FIELDS(
+    Airport::RunwayStatusChangedEvent, v.icao, v.runway, v.active, v.isArrival)
+NEORADAR_RECORDING_FIELDS(Airport::AirportConfigurationsUpdatedEvent, v.configurationCount)
+
+NEORADAR_RECORDING_FIELDS(Controller::Controller, v.callsign, v.name, v.cid, v.rating,
+    v.facility, v.latitude, v.longitude, v.frequencies, v.atisLines, v.atisLetter, v.isATC,
+    v.isATIS, v.sectorFileName)
+NEORADAR_RECORDING_FIELDS(Controller::AtcPositionUpdateEvent, v.callsign, v.latitude, v.longitude)
+NEORADAR_RECORDING_FIELDS(Controller::AtisLinesUpdateEvent, v.callsign, v.lineCount)
+NEORADAR_RECORDING_FIELDS(Controller::CapabilitiesUpdateEvent, v.callsign)
+NEORADAR_RECORDING_FIELDS(Controller::ControllerDisconnectedEvent, v.callsign)
+NEORADAR_RECORDING_FIELDS(
+    Controller::ControllerConnectedEvent, v.callsign, v.name, v.cid, v.rating, v.facility)
+NEORADAR_RECORDING_FIELDS(Controller::IsControllerATCEvent, v.callsign, v.isATC)
+
+NEORADAR_RECORDING_FIELDS(ControllerData::ControllerDataModel, v.callsign,
+    v.clearedFlightLevel, v.assignedDirect, v.assignedHeading, v.assignedSpeed,
+    v.assignedMach, v.assignedVerticalRate, v.assignedSquawk, v.scratchpad, v.rawScratchpad,
+    v.clearanceIssued, v.ownedByMe, v.ownedByCallsign, v.futureOwnerCallsign,
+    v.assignedSpeedVariance, v.attentionState, v.groundStatus, v.clearanceQueuePosition)
+NEORADAR_RECORDING_FIELDS(ControllerData::ControllerDataUpdatedEvent, v.callsign)
+NEORADAR_RECORDING_FIELDS(
+    ControllerData::AircraftBeaconCodeChangedEvent, v.callsign, v.oldCode, v.newCode)
+NEORADAR_RECORDING_FIELDS(
+    ControllerData::AircraftHandoffCancelledEvent, v.callsign, v.oldOwner, v.newOwner)
+NEORADAR_RECORDING_FIELDS(
+    ControllerData::AircraftOwnedByChangedEvent, v.callsign, v.oldOwner, v.newOwner)
+NEORADAR_RECORDING_FIELDS(ControllerData::AircraftHandoffRejectedEvent, v.callsign, v.from)
+NEORADAR_RECORDING_FIELDS(ControllerData::AircraftTerminatedTrackingEvent, v.callsign)
+NEORADAR_RECORDING_FIELDS(ControllerData::AircraftInitiatedTrackingEvent, v.callsign)
+NEORADAR_RECORDING_FIELDS(ControllerData::AircraftTemporaryAltitudeChangedEvent, v.callsign,
+    v.oldAltitude, v.newAltitude)
+NEORADAR_RECORDING_FIELDS(ControllerData::AircraftCDMStatusChangedEvent, v.callsign,
+    v.clearanceIssued, v.groundStatus)
+NEORADAR_RECORDING_FIELDS(ControllerData::AircraftScratchpadUpdatedEvent, v.callsign, v.scratchpad)
+NEORADAR_RECORDING_FIELDS(
+    ControllerData::AircraftHeadingChangedEvent, v.callsign, v.oldHeading, v.newHeading)
+NEORADAR_RECORDING_FIELDS(
+    ControllerData::AircraftAssignedSpeedChangedEvent, v.callsign, v.oldSpeed, v.newSpeed)
+
+NEORADAR_RECORDING_FIELDS(Flightplan::Position, v.latitude, v.longitude)
+NEORADAR_RECORDING_FIELDS(Flightplan::Waypoint, v.type, v.identifier, v.position, v.frequencyHz)
+NEORADAR_RECORDING_FIELDS(Flightplan::PlannedAltitudeAndSpeed, v.plannedAltitude,
+    v.plannedSpeed, v.altitudeUnit, v.speedUnit)
+NEORADAR_RECORDING_FIELDS(Flightplan::RouteWaypoint, v.type, v.identifier, v.position,
+    v.frequencyHz, v.plannedPosition, v.flightRule)
+NEORADAR_RECORDING_FIELDS(
+    Flightplan::ParsingError, v.type, v.message, v.tokenIndex, v.token, v.level)
+NEORADAR_RECORDING_FIELDS(
+    Flightplan::ParsedRouteSegment, v.from, v.to, v.airway, v.heading, v.minimumLevel)
+NEORADAR_RECORDING_FIELDS(Flightplan::Route, v.rawRoute, v.waypoints, v.segments,
+    v.explicitSegments, v.errors, v.originalSegments, v.hasDirectApplied,
+    v.currentDirectWaypoint, v.sid, v.star, v.suggestedSid, v.suggestedStar, v.depRunway,
+    v.arrRunway, v.suggestedDepRunway, v.suggestedArrRunway, v.isAmended)
+NEORADAR_RECORDING_FIELDS(Flightplan::Flightplan, v.callsign, v.flightRule, v.rawType,
+    v.acType, v.equipment, v.wakeCategory, v.transponderEquipment, v.origin, v.destination,
+    v.alternate, v.originWaypoint, v.destinationWaypoint, v.alternateWaypoint, v.route,
+    v.plannedAltitude, v.plannedTas, v.flightTimeHours, v.flightTimeMinutes, v.fuelTimeHours,
+    v.fuelTimeMinutes, v.eobt, v.aobt, v.remarks, v.isValid, v.voiceType)
+NEORADAR_RECORDING_FIELDS(Flightplan::FlightplanUpdatedEvent, v.callsign, v.origin,
+    v.destination, v.route, v.acType, v.altitude, v.rules)
+NEORADAR_RECORDING_FIELDS(Flightplan::FlightplanRemovedEvent, v.callsign)
+NEORADAR_RECORDING_FIELDS(
+    Flightplan::FlightplanVoiceTypeChangedEvent, v.callsign, v.oldVoiceType, v.newVoiceType)
+NEORADAR_RECORDING_FIELDS(Flightplan::FlightplanRouteChangedEvent, v.callsign, v.newRoute)
+
+NEORADAR_RECORDING_FIELDS(Fsd::ConnectionInfo, v.callsign, v.cid, v.name, v.rating, v.facility,
+    v.serverType, v.isConnected, v.atisLines, v.frequencies)
+NEORADAR_RECORDING_FIELDS(Fsd::FsdErrorEvent, v.message)
+NEORADAR_RECORDING_FIELDS(Fsd::FsdConnectionStateChangeEvent, v.state)
+NEORADAR_RECORDING_FIELDS(Fsd::FsdConnectedEvent, v.callsign, v.server, v.facilityType)
+NEORADAR_RECORDING_FIELDS(Fsd::FsdDisconnectedEvent, v.reason, v.userInitiated)
+NEORADAR_RECORDING_FIELDS(Fsd::FsdConnectionModelUpdatedEvent, v.callsign)
+
+NEORADAR_RECORDING_FIELDS(
+    Chat::FlightplanMessageReceivedEvent, v.requestType, v.callsign, v.request)
+NEORADAR_RECORDING_FIELDS(Chat::ATISInfoMessageReceivedEvent, v.callsign, v.icao, v.atisLetter)
+NEORADAR_RECORDING_FIELDS(
+    Chat::FrequencyMessageReceivedEvent, v.sentFrom, v.message, v.frequencies, v.fromMe)
+NEORADAR_RECORDING_FIELDS(
+    Chat::PrivateMessageReceivedEvent, v.sentFrom, v.sentTo, v.message, v.fromMe)
+NEORADAR_RECORDING_FIELDS(Chat::BroadcastMessageReceivedEvent, v.sentFrom, v.message, v.fromMe)
+NEORADAR_RECORDING_FIELDS(Chat::SupervisorMessageReceivedEvent, v.sentFrom, v.message, v.fromMe)
+NEORADAR_RECORDING_FIELDS(Chat::ServerMessageReceivedEvent, v.sentFrom, v.message)
+NEORADAR_RECORDING_FIELDS(Chat::AtcMessageReceivedEvent, v.sentFrom, v.message)
+
+// SquawkAssignedEvent holds borrowed C strings and is decoded through SquawkAssignedRecord
+struct SquawkAssignedRecord {
+    std::string callsign;
+    std::string squawk;
+    std::string providerName;
+    Squawk::SquawkAssignedEvent event;
+};
+
+template <typename Archive> void describe(Archive& ar, const Squawk::SquawkAssignedEvent& v)
+{
+    ar(v.callsign, v.squawk, v.providerName);
+}
+NEORADAR_RECORDING_FIELDS(SquawkAssignedRecord, v.callsign, v.squawk, v.providerName)
+NEORADAR_RECORDING_FIELDS(Squawk::DuplicateSquawkEvent, v.squawk, v.callsigns, v.isDuplicate)
+
+NEORADAR_RECORDING_FIELDS(
+    Tag::TagActionEvent, v.actionId, v.tagId, v.callsign, v.button, v.userInput, v.data)
+NEORADAR_RECORDING_FIELDS(Tag::DropdownActionEvent, v.actionId, v.componentId, v.tagId,
+    v.callsign, v.userInput, v.data)
+
+NEORADAR_RECORDING_FIELDS(Snapshot, v.aircraft, v.flightplans, v.controllers,
+    v.controllerData, v.airports, v.connection)
+
+#undef NEORADAR_RECORDING_FIELDS
+
+} // namespace PluginSDK::Recording::detail
@@ -0,0 +1,114 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+Aircraft::Aircraft aircraft(const std::string& callsign, const std::string& squawk = "2000")
+{
+    Aircraft::Aircraft result;
+    result.callsign = callsign;
+    result.squawk = squawk;
+    return result;
+}
+
+Recording::Snapshot snapshot(std::vector<Aircraft::Aircraft> aircraft)
+{
+    Recording::Snapshot result;
+    result.aircraft = std::move(aircraft);
+    return result;
+}
+
+bool equal(std::vector<std::string> actual, std::vector<std::string> expected)
+{
+    std::sort(actual.begin(), actual.end());
+    std::sort(expected.begin(), expected.end());
+    return actual == expected;
+}
+
+void testNetChanges()
+{
+    Replay::ReplayHost host;
+    Aircraft::AircraftAPI& api = host.aircraft();
+    CHECK(api.getSequence() == 0);
+
+    host.setSnapshot(snapshot({ aircraft("DLH1"), aircraft("DLH2"), aircraft("DLH3") }));
+    const std::uint64_t start = api.getSequence();
+    CHECK(start == 3);
+
+    const ChangeSet initial = api.changesSince(0);
+    CHECK(!initial.truncated);
+    CHECK(initial.sequence == start);
+    CHECK(equal(initial.inserted, { "DLH1", "DLH2", "DLH3" }));
+    CHECK(initial.updated.empty() && initial.removed.empty());
+
+    // An unchanged snapshot records nothing
+    host.setSnapshot(snapshot({ aircraft("DLH1"), aircraft("DLH2"), aircraft("DLH3") }));
+    CHECK(api.getSequence() == start);
+
+    // DLH1 updated, DLH2 removed, DLH4 inserted then updated, DLH5 inserted
+    // then removed, DLH3 removed then inserted again
+    host.setSnapshot(snapshot({ aircraft("DLH1", "1000"), aircraft("DLH4"), aircraft("DLH5") }));
+    host.setSnapshot(snapshot(
+        { aircraft("DLH1", "1000"), aircraft("DLH3"), aircraft("DLH4", "4000") }));
+
+    const ChangeSet changes = api.changesSince(start);
+    CHECK(!changes.truncated);
+    CHECK(changes.sequence == api.getSequence());
+    CHECK(equal(changes.inserted, { "DLH4" }));
+    CHECK(equal(changes.updated, { "DLH1", "DLH3" }));
+    CHECK(equal(changes.removed, { "DLH2" }));
+
+    const ChangeSet none = api.changesSince(changes.sequence);
+    CHECK(!none.truncated);
+    CHECK(none.inserted.empty() && none.updated.empty() && none.removed.empty());
+}
+
+// Once the bounded log has discarded entries, older sequences are truncated
+void testWrap()
+{
+    Replay::ReplayHost host;
+    Aircraft::AircraftAPI& api = host.aircraft();
+
+    std::vector<Aircraft::Aircraft> many;
+    for (int i = 0; i < 5000; ++i) {
+        many.push_back(aircraft("AC" + std::to_string(i)));
+    }
+    host.setSnapshot(snapshot(many));
+    const std::uint64_t sequence = api.getSequence();
+    CHECK(sequence == 5000);
+
+    const ChangeSet all = api.changesSince(0);
+    CHECK(all.truncated);
+    CHECK(all.sequence == sequence);
+    CHECK(all.inserted.empty() && all.updated.empty() && all.removed.empty());
+
+    // The most recent changes are still served
+    many[4999].squawk = "7000";
+    host.setSnapshot(snapshot(many));
+    const ChangeSet recent = api.changesSince(sequence - 10);
+    CHECK(!recent.truncated);
+    CHECK(recent.inserted.size() == 10);
+    CHECK(equal(recent.updated, {}));
+    CHECK(std::find(recent.inserted.begin(), recent.inserted.end(), "AC4999")
+        != recent.inserted.end());
+
+    const ChangeSet latest = api.changesSince(sequence);
+    CHECK(!latest.truncated);
+    CHECK(equal(latest.updated, { "AC4999" }));
+}
+
+} // namespace
+
+int main()
+{
+    testNetChanges();
+    testWrap();
+    return Testing::result();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdio>
+
+namespace PluginSDK::Testing {
+
+// Number of failed CHECKs so far; main returns non-zero if any failed
+inline int& failures()
+{
+    static int count = 0;
+    return count;
+}
+
+inline int result() { return failures() == 0 ? 0 : 1; }
+
+} // namespace PluginSDK::Testing
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++PluginSDK::Testing::failures();                                              \
+        }                                                                                  \
+    } while (false)
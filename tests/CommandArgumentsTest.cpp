@@ -0,0 +1,69 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+class SpeedCommand : public Chat::CommandProvider {
+public:
+    Chat::CommandResult Execute(const std::string&, const std::vector<std::string>&) override
+    {
+        return { false, std::string("unparsed call") };
+    }
+
+    Chat::CommandResult ExecuteParsed(
+        const std::string&, const Chat::ParsedCommandArguments& args) override
+    {
+        speeds.push_back(args[1].number);
+        return { true, std::nullopt };
+    }
+
+    std::vector<double> speeds;
+};
+
+bool rejected(Replay::ReplayHost& host, const std::string& line)
+{
+    const auto result = host.executeCommand(line);
+    return result && !result->success && result->message
+        && result->message->find("speed: not a number") != std::string::npos;
+}
+
+void testNumbers()
+{
+    Replay::ReplayHost host;
+    const auto provider = std::make_shared<SpeedCommand>();
+    Chat::CommandDefinition definition;
+    definition.name = "speed";
+    definition.parameters = { { "callsign", Chat::ParameterType::String },
+        { "speed", Chat::ParameterType::Number } };
+    host.chat().registerCommand("speed", definition, provider);
+
+    const auto accepted = host.executeCommand(".speed DLH1 250");
+    CHECK(accepted && accepted->success);
+    CHECK(host.executeCommand(".speed DLH1 -12.5e1"));
+    CHECK((provider->speeds == std::vector<double> { 250, -125 }));
+
+    // Non-finite, hex and partial numbers never reach the handler
+    CHECK(rejected(host, ".speed DLH1 nan"));
+    CHECK(rejected(host, ".speed DLH1 inf"));
+    CHECK(rejected(host, ".speed DLH1 -infinity"));
+    CHECK(rejected(host, ".speed DLH1 0x1p4"));
+    CHECK(rejected(host, ".speed DLH1 250kt"));
+    CHECK(rejected(host, ".speed DLH1 1e999"));
+    CHECK(provider->speeds.size() == 2);
+}
+
+} // namespace
+
+int main()
+{
+    testNumbers();
+    return Testing::result();
+}
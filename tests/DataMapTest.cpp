@@ -0,0 +1,96 @@
+#include "Check.h"
+
+#include <NeoRadarSDK/DataMap.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+std::vector<std::string> values(const DataMap& map)
+{
+    std::vector<std::string> result;
+    for (const auto& [key, value] : map) {
+        result.push_back(value);
+    }
+    return result;
+}
+
+void testEmpty()
+{
+    const DataMap map;
+    CHECK(map.empty());
+    CHECK(map.find("speed") == map.end());
+    CHECK(!map.contains("speed"));
+}
+
+// Growing past the capacity reserved by the first insert keeps every entry
+void testSpill()
+{
+    DataMap map;
+    for (int i = 0; i < 10; ++i) {
+        map.set("key" + std::to_string(i), std::to_string(i));
+    }
+    CHECK(map.size() == 10);
+    for (int i = 0; i < 10; ++i) {
+        const std::string key = "key" + std::to_string(i);
+        CHECK(map.contains(key));
+        CHECK(map.at(key) == std::to_string(i));
+    }
+    const std::vector<std::string> expected { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9" };
+    CHECK(values(map) == expected);
+
+    map.set("key3", "three");
+    CHECK(map.size() == 10);
+    CHECK(map.at("key3") == "three");
+}
+
+void testErase()
+{
+    DataMap map { { "a", "1" }, { "b", "2" }, { "c", "3" }, { "d", "4" }, { "e", "5" } };
+    CHECK(map.erase("c") == 1);
+    CHECK(map.erase("c") == 0);
+    CHECK(map.size() == 4);
+    CHECK(!map.contains("c"));
+    CHECK((values(map) == std::vector<std::string> { "1", "2", "4", "5" }));
+
+    const auto next = map.erase(map.find("a"));
+    CHECK(next != map.end() && next->second == "2");
+    CHECK((values(map) == std::vector<std::string> { "2", "4", "5" }));
+
+    map["f"] = "6";
+    CHECK((values(map) == std::vector<std::string> { "2", "4", "5", "6" }));
+
+    map.clear();
+    CHECK(map.empty());
+    map["a"] = "again";
+    CHECK(map.at("a") == "again");
+}
+
+void testAt()
+{
+    const DataMap map { { "a", "1" } };
+    bool thrown = false;
+    try {
+        map.at("missing");
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(map.count("a") == 1);
+    CHECK(map.count("missing") == 0);
+}
+
+} // namespace
+
+int main()
+{
+    testEmpty();
+    testSpill();
+    testErase();
+    testAt();
+    return Testing::result();
+}
@@ -0,0 +1,106 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+Recording::Snapshot fleet(const std::vector<std::pair<std::string, std::string>>& squawks)
+{
+    Recording::Snapshot snapshot;
+    for (const auto& [callsign, squawk] : squawks) {
+        Aircraft::Aircraft aircraft;
+        aircraft.callsign = callsign;
+        aircraft.squawk = squawk;
+        snapshot.aircraft.push_back(aircraft);
+    }
+    return snapshot;
+}
+
+std::vector<Squawk::DuplicateSquawkEvent> duplicates(Replay::ReplayHost& host)
+{
+    std::vector<Squawk::DuplicateSquawkEvent> events;
+    for (const auto& event : host.takeHostEvents()) {
+        CHECK(event->type() == EventType::DuplicateSquawk);
+        events.push_back(*static_cast<const Squawk::DuplicateSquawkEvent*>(event->data()));
+    }
+    return events;
+}
+
+void changeCode(Replay::ReplayHost& host, const std::string& callsign, const std::string& code)
+{
+    const ControllerData::AircraftBeaconCodeChangedEvent event { callsign, "", code };
+    host.trackEntities(EventType::AircraftBeaconCodeChanged, &event);
+}
+
+void testTransitions()
+{
+    Replay::ReplayHost host;
+    Squawk::SquawkAPI& squawk = host.squawk();
+    host.setSnapshot(fleet({ { "DLH1", "1000" }, { "DLH2", "2000" } }));
+    CHECK(duplicates(host).empty());
+    CHECK(squawk.getDuplicateSquawks().empty());
+
+    // One to two holders
+    changeCode(host, "DLH2", "1000");
+    auto events = duplicates(host);
+    CHECK(events.size() == 1);
+    CHECK(events[0].squawk == "1000");
+    CHECK(events[0].isDuplicate);
+    CHECK(events[0].callsigns.size() == 2);
+    CHECK(squawk.getDuplicateSquawks() == std::vector<std::string>({ "1000" }));
+    CHECK(squawk.getCallsignsBySquawk("1000").size() == 2);
+    CHECK(squawk.getCallsignsBySquawk("2000").empty());
+
+    // A third holder is not a new duplicate
+    changeCode(host, "BAW1", "1000");
+    CHECK(duplicates(host).empty());
+
+    // Three to two neither, two to one clears it
+    const Aircraft::AircraftDisconnectedEvent disconnected { "BAW1" };
+    host.trackEntities(EventType::AircraftDisconnected, &disconnected);
+    CHECK(duplicates(host).empty());
+    changeCode(host, "DLH1", "3000");
+    events = duplicates(host);
+    CHECK(events.size() == 1);
+    CHECK(events[0].squawk == "1000");
+    CHECK(!events[0].isDuplicate);
+    CHECK(events[0].callsigns == std::vector<std::string>({ "DLH2" }));
+    CHECK(squawk.getDuplicateSquawks().empty());
+    CHECK(squawk.getCallsignsBySquawk("3000") == std::vector<std::string>({ "DLH1" }));
+}
+
+void testSnapshots()
+{
+    Replay::ReplayHost host;
+    Squawk::SquawkAPI& squawk = host.squawk();
+    host.setSnapshot(fleet({ { "DLH1", "7000" }, { "DLH2", "7000" }, { "DLH3", "1234" } }));
+    auto events = duplicates(host);
+    CHECK(events.size() == 1);
+    CHECK(events[0].squawk == "7000" && events[0].isDuplicate);
+
+    // The same state again raises nothing
+    host.setSnapshot(fleet({ { "DLH1", "7000" }, { "DLH2", "7000" }, { "DLH3", "1234" } }));
+    CHECK(duplicates(host).empty());
+
+    // An aircraft leaving the snapshot clears its duplicate
+    host.setSnapshot(fleet({ { "DLH1", "7000" }, { "DLH3", "1234" } }));
+    events = duplicates(host);
+    CHECK(events.size() == 1);
+    CHECK(events[0].squawk == "7000" && !events[0].isDuplicate);
+    CHECK(squawk.getCallsignsBySquawk("7000") == std::vector<std::string>({ "DLH1" }));
+    CHECK(squawk.getCallsignsBySquawk("not a code").empty());
+}
+
+} // namespace
+
+int main()
+{
+    testTransitions();
+    testSnapshots();
+    return Testing::result();
+}
@@ -0,0 +1,124 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <NeoRadarSDK/Recording.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+struct BatchingPlugin : BasePlugin {
+    explicit BatchingPlugin(Dispatch::DispatchMode mode)
+        : mode(mode)
+    {
+    }
+
+    void Initialize(const PluginMetadata&, CoreAPI*, ClientInformation) override { }
+    void Shutdown() override { }
+    PluginMetadata GetMetadata() const override { return { "batching", "1.0", "tests" }; }
+    EventMask GetEventSubscriptions() const override
+    {
+        return { EventType::AircraftOwnedByChanged, EventType::SquawkAssigned };
+    }
+    EventMask GetBatchedEvents() const override { return GetEventSubscriptions(); }
+    Dispatch::DispatchOptions GetDispatchOptions() const override
+    {
+        Dispatch::DispatchOptions options;
+        options.mode = mode;
+        return options;
+    }
+
+    // Payloads are read during the call, while the batch owns them
+    void OnEventBatch(const EventBatch& batch) override
+    {
+        for (const BatchedEvent& event : batch) {
+            if (const auto* owned = event.as<EventType::AircraftOwnedByChanged>()) {
+                received.push_back(owned->callsign + " " + owned->newOwner);
+            } else if (const auto* assigned = event.as<EventType::SquawkAssigned>()) {
+                received.push_back(std::string(assigned->callsign) + " " + assigned->squawk);
+            }
+        }
+    }
+
+    Dispatch::DispatchMode mode;
+    std::vector<std::string> received;
+};
+
+const std::vector<std::string> Expected { "DLH1 EDDF_APP", "DLH2 EDDF_APP", "DLH3 EDDF_DEP",
+    "DLH1 4721" };
+
+std::filesystem::path record()
+{
+    const std::filesystem::path path
+        = std::filesystem::temp_directory_path() / "neoradar-event-batch-test.nrrec";
+    Replay::ReplayHost host;
+    Recording::RecordingPlugin recorder(
+        std::make_unique<BatchingPlugin>(Dispatch::DispatchMode::Inline), path,
+        std::chrono::hours(1));
+    recorder.Initialize({ "batching", "1.0", "tests" }, &host, {});
+    const std::vector<ControllerData::AircraftOwnedByChangedEvent> handoffs {
+        { "DLH1", "", "EDDF_APP" }, { "DLH2", "", "EDDF_APP" }, { "DLH3", "", "EDDF_DEP" }
+    };
+    for (const ControllerData::AircraftOwnedByChangedEvent& handoff : handoffs) {
+        recorder.OnAircraftOwnedByChanged(&handoff);
+    }
+    const Squawk::SquawkAssignedEvent assigned { "DLH1", "4721", "local" };
+    recorder.OnSquawkAssigned(&assigned);
+    recorder.Shutdown();
+    return path;
+}
+
+void testBatches(const std::filesystem::path& path, Dispatch::DispatchMode mode)
+{
+    Replay::ReplayHost host;
+    BatchingPlugin plugin(mode);
+    Recording::RecordingReader reader;
+    CHECK(reader.open(path));
+    const Replay::ReplayReport report = Replay::replay(reader, plugin, host, { 0 });
+    CHECK(plugin.received == Expected);
+    CHECK(report.batches.count >= 1);
+}
+
+void testTakeEvent(const std::filesystem::path& path)
+{
+    Recording::RecordingReader reader;
+    CHECK(reader.open(path));
+    std::vector<std::unique_ptr<Recording::RecordedEvent>> events;
+    while (reader.next()) {
+        if (reader.kind() == Recording::RecordKind::Event) {
+            events.push_back(reader.takeEvent());
+            CHECK(!reader.event());
+        }
+    }
+
+    // Every taken event keeps its own payload
+    CHECK(events.size() == 4);
+    std::vector<std::string> callsigns;
+    for (const auto& event : events) {
+        if (event->type() == EventType::AircraftOwnedByChanged) {
+            callsigns.push_back(
+                static_cast<const ControllerData::AircraftOwnedByChangedEvent*>(event->data())
+                    ->callsign);
+        }
+    }
+    CHECK(callsigns == std::vector<std::string>({ "DLH1", "DLH2", "DLH3" }));
+}
+
+} // namespace
+
+int main()
+{
+    const std::filesystem::path path = record();
+    testBatches(path, Dispatch::DispatchMode::Inline);
+    testBatches(path, Dispatch::DispatchMode::Isolated);
+    testTakeEvent(path);
+    std::filesystem::remove(path);
+    return Testing::result();
+}
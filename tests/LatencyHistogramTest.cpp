@@ -0,0 +1,96 @@
+#include "Check.h"
+
+#include "LatencyHistogram.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using namespace PluginSDK;
+using Replay::LatencyHistogram;
+
+namespace {
+
+void testExactBuckets()
+{
+    for (std::uint64_t value = 0; value < LatencyHistogram::SubBuckets; ++value) {
+        CHECK(LatencyHistogram::bucket(value) == value);
+        CHECK(LatencyHistogram::midpoint(LatencyHistogram::bucket(value)) == value);
+    }
+}
+
+void testBucketBoundaries()
+{
+    // Each power of two from SubBuckets on is split into SubBuckets buckets
+    CHECK(LatencyHistogram::bucket(16) == 16);
+    CHECK(LatencyHistogram::bucket(31) == 31);
+    CHECK(LatencyHistogram::bucket(32) == 32);
+    CHECK(LatencyHistogram::bucket(33) == 32);
+    CHECK(LatencyHistogram::bucket(34) == 33);
+    CHECK(LatencyHistogram::bucket(63) == 47);
+    CHECK(LatencyHistogram::bucket(64) == 48);
+
+    // Values past MaxBits share the last bucket
+    const std::size_t last = LatencyHistogram::BucketCount - 1;
+    CHECK(LatencyHistogram::bucket((std::uint64_t(1) << LatencyHistogram::MaxBits) - 1) == last);
+    CHECK(LatencyHistogram::bucket(std::numeric_limits<std::uint64_t>::max()) == last);
+}
+
+void testMidpointError()
+{
+    std::size_t previous = 0;
+    for (std::uint64_t value = 1; value < (std::uint64_t(1) << 40); value = value * 5 / 4 + 1) {
+        const std::size_t index = LatencyHistogram::bucket(value);
+        CHECK(index >= previous);
+        previous = index;
+        const double error
+            = std::abs(LatencyHistogram::midpoint(index) - static_cast<double>(value));
+        CHECK(error <= static_cast<double>(value) / (2 * LatencyHistogram::SubBuckets));
+    }
+}
+
+void testSummary()
+{
+    LatencyHistogram histogram;
+    CHECK(histogram.summary().count == 0);
+
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    const Metrics::LatencySummary summary = histogram.summary();
+    CHECK(summary.count == 1000);
+    CHECK(summary.total.count() == 500500);
+    CHECK(summary.max.count() == 1000);
+    CHECK(std::abs(summary.p50.count() - 500) <= 500 / 32);
+    CHECK(std::abs(summary.p99.count() - 990) <= 990 / 32);
+
+    // Percentiles never exceed the exact max
+    LatencyHistogram single;
+    single.record(1000);
+    CHECK(single.summary().p50.count() == 1000);
+    CHECK(single.summary().p99.count() == 1000);
+
+    histogram.reset();
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.summary().max.count() == 0);
+}
+
+void testUnitConversion()
+{
+    LatencyHistogram histogram;
+    histogram.record(10);
+    CHECK(histogram.summary(2.5).max.count() == 25);
+    CHECK(histogram.summary(2.5).total.count() == 25);
+}
+
+} // namespace
+
+int main()
+{
+    testExactBuckets();
+    testBucketBoundaries();
+    testMidpointError();
+    testSummary();
+    testUnitConversion();
+    return Testing::result();
+}
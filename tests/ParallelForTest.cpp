@@ -0,0 +1,67 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+using namespace PluginSDK;
+
+namespace {
+
+void testCoverage()
+{
+    Replay::ReplayHost host;
+    std::atomic<std::size_t> sum { 0 };
+    host.scheduler().parallelFor(
+        1000,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                sum += i;
+            }
+        },
+        7);
+    CHECK(sum == 999 * 1000 / 2);
+}
+
+void testException()
+{
+    Replay::ReplayHost host;
+    std::atomic<std::size_t> ran { 0 };
+    std::string caught;
+    try {
+        host.scheduler().parallelFor(
+            64,
+            [&](std::size_t begin, std::size_t) {
+                ++ran;
+                if (begin == 8) {
+                    throw std::runtime_error("range 8");
+                }
+            },
+            1);
+    } catch (const std::runtime_error& error) {
+        caught = error.what();
+    }
+    CHECK(caught == "range 8");
+    CHECK(ran >= 1 && ran <= 64);
+
+    // The pool is still usable and nothing is left running
+    std::atomic<std::size_t> count { 0 };
+    host.scheduler().parallelFor(
+        64, [&](std::size_t begin, std::size_t end) { count += end - begin; }, 1);
+    CHECK(count == 64);
+    const std::size_t after = ran;
+    host.waitForIdle();
+    CHECK(ran == after);
+}
+
+} // namespace
+
+int main()
+{
+    testCoverage();
+    testException();
+    return Testing::result();
+}
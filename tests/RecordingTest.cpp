@@ -0,0 +1,127 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <NeoRadarSDK/Recording.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace PluginSDK;
+
+namespace {
+
+struct CountingPlugin : BasePlugin {
+    int positionUpdates = 0;
+    int privateMessages = 0;
+
+    void Initialize(const PluginMetadata&, CoreAPI*, ClientInformation) override { }
+    void Shutdown() override { }
+    PluginMetadata GetMetadata() const override { return { "counting", "1.0", "tests" }; }
+    EventMask GetEventSubscriptions() const override { return { EventType::PositionUpdate }; }
+
+    void OnPositionUpdate(const Aircraft::PositionUpdateEvent*) override { ++positionUpdates; }
+    void OnPrivateMessageReceived(const Chat::PrivateMessageReceivedEvent*) override
+    {
+        ++privateMessages;
+    }
+};
+
+void testRoundTrip()
+{
+    const std::filesystem::path path
+        = std::filesystem::temp_directory_path() / "neoradar-recording-test.nrrec";
+
+    Aircraft::Aircraft dlh;
+    dlh.callsign = "DLH123";
+    dlh.squawk = "1000";
+    dlh.position.latitude = 50.0333;
+    dlh.position.altitude = 12000;
+    Recording::Snapshot state;
+    state.aircraft = { dlh };
+
+    Replay::ReplayHost host;
+    host.setSnapshot(state);
+
+    auto owned = std::make_unique<CountingPlugin>();
+    CountingPlugin& counting = *owned;
+    {
+        Recording::RecordingPlugin recorder(std::move(owned), path, std::chrono::hours(1));
+        recorder.Initialize({ "counting", "1.0", "tests" }, &host,
+            { "NeoRadar", "1.2.3", "4.5", "1.2.3-4.5", "/documents" });
+
+        Aircraft::PositionUpdateEvent update;
+        update.aircrafts = { dlh };
+        recorder.OnPositionUpdate(&update);
+
+        Chat::PrivateMessageReceivedEvent message { "EDDF_TWR", "DLH123", "hello", false };
+        recorder.OnPrivateMessageReceived(&message);
+
+        Squawk::SquawkAssignedEvent squawk { "DLH123", "4721", "local" };
+        recorder.OnSquawkAssigned(&squawk);
+
+        recorder.Shutdown();
+
+        // Every event is recorded, but only subscribed ones reach the plugin
+        CHECK(counting.positionUpdates == 1);
+        CHECK(counting.privateMessages == 0);
+    }
+
+    Recording::RecordingReader reader;
+    CHECK(reader.open(path));
+    CHECK(reader.metadata().name == "counting");
+    CHECK(reader.metadata().author == "tests");
+    CHECK(reader.clientInformation().clientVersion == "1.2.3");
+    CHECK(reader.clientInformation().documentsPath == "/documents");
+
+    // A snapshot precedes the first event
+    CHECK(reader.next() && reader.kind() == Recording::RecordKind::Snapshot);
+    CHECK(reader.snapshot().aircraft.size() == 1);
+    CHECK(Recording::encode(reader.snapshot().aircraft.at(0)) == Recording::encode(dlh));
+
+    CHECK(reader.next() && reader.eventType() == EventType::PositionUpdate);
+    const auto* update = static_cast<const Aircraft::PositionUpdateEvent*>(reader.event());
+    CHECK(update && update->aircrafts.size() == 1);
+    CHECK(update && Recording::encode(update->aircrafts.at(0)) == Recording::encode(dlh));
+    std::chrono::nanoseconds previous = reader.timestamp();
+
+    CHECK(reader.next() && reader.eventType() == EventType::PrivateMessageReceived);
+    const auto* message = static_cast<const Chat::PrivateMessageReceivedEvent*>(reader.event());
+    CHECK(message && message->sentFrom == "EDDF_TWR" && message->message == "hello");
+    CHECK(reader.timestamp() >= previous);
+    previous = reader.timestamp();
+
+    CHECK(reader.next() && reader.eventType() == EventType::SquawkAssigned);
+    const auto* squawk = static_cast<const Squawk::SquawkAssignedEvent*>(reader.event());
+    CHECK(squawk && std::strcmp(squawk->callsign, "DLH123") == 0);
+    CHECK(squawk && std::strcmp(squawk->squawk, "4721") == 0);
+    CHECK(squawk && std::strcmp(squawk->providerName, "local") == 0);
+
+    // The copy outlives the reader's current record
+    const std::unique_ptr<Recording::RecordedEvent> copy = reader.copyEvent();
+    CHECK(copy && copy->type() == EventType::SquawkAssigned);
+
+    CHECK(!reader.next());
+    CHECK(reader.kind() == Recording::RecordKind::End);
+    CHECK(reader.timestamp() >= previous);
+
+    std::filesystem::remove(path);
+}
+
+void testMissingFile()
+{
+    Recording::RecordingReader reader;
+    CHECK(!reader.open(std::filesystem::temp_directory_path() / "neoradar-missing.nrrec"));
+}
+
+} // namespace
+
+int main()
+{
+    testRoundTrip();
+    testMissingFile();
+    return Testing::result();
+}
@@ -0,0 +1,124 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <NeoRadarSDK/Recording.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+class FixedProvider : public Squawk::SquawkProviderInterface {
+public:
+    std::string GenerateSquawk(
+        const std::string&, const Aircraft::Aircraft&, const Flightplan::Flightplan&) override
+    {
+        return "4721";
+    }
+
+    std::string GetProviderName() const override { return "fixed"; }
+    int GetPriority() const override { return 0; }
+};
+
+struct AssigningPlugin : BasePlugin {
+    explicit AssigningPlugin(Replay::ReplayHost& host, EventMask subscriptions)
+        : host(host)
+        , subscriptions(subscriptions)
+    {
+    }
+
+    void Initialize(const PluginMetadata&, CoreAPI*, ClientInformation) override { }
+    void Shutdown() override { }
+    PluginMetadata GetMetadata() const override { return { "assigning", "1.0", "tests" }; }
+    EventMask GetEventSubscriptions() const override { return subscriptions; }
+
+    void OnPositionUpdate(const Aircraft::PositionUpdateEvent*) override
+    {
+        host.squawk().assignSquawks({ "DLH1" });
+    }
+
+    void OnSquawkAssigned(const Squawk::SquawkAssignedEvent* event) override
+    {
+        assigned.push_back(std::string(event->callsign) + " " + event->squawk + " "
+            + event->providerName);
+    }
+
+    Replay::ReplayHost& host;
+    EventMask subscriptions;
+    std::vector<std::string> assigned;
+};
+
+std::filesystem::path record()
+{
+    const std::filesystem::path path
+        = std::filesystem::temp_directory_path() / "neoradar-squawk-assign-test.nrrec";
+    Aircraft::Aircraft aircraft;
+    aircraft.callsign = "DLH1";
+    Flightplan::Flightplan flightplan;
+    flightplan.callsign = "DLH1";
+    Recording::Snapshot state;
+    state.aircraft = { aircraft };
+    state.flightplans = { flightplan };
+
+    Replay::ReplayHost host;
+    host.setSnapshot(state);
+    Recording::RecordingPlugin recorder(std::make_unique<AssigningPlugin>(host, EventMask {}),
+        path, std::chrono::hours(1));
+    recorder.Initialize({ "assigning", "1.0", "tests" }, &host, {});
+    Aircraft::PositionUpdateEvent update;
+    update.aircrafts = { aircraft };
+    recorder.OnPositionUpdate(&update);
+    recorder.Shutdown();
+    return path;
+}
+
+void testDelivery(const std::filesystem::path& path)
+{
+    Replay::ReplayHost host;
+    CHECK(host.squawk().registerProvider(std::make_shared<FixedProvider>()));
+    AssigningPlugin plugin(host, { EventType::PositionUpdate, EventType::SquawkAssigned });
+    Recording::RecordingReader reader;
+    CHECK(reader.open(path));
+    const Replay::ReplayReport report = Replay::replay(reader, plugin, host, { 0 });
+
+    // Delivered once, through the dispatch path and its latency samples
+    CHECK(plugin.assigned == std::vector<std::string>({ "DLH1 4721 fixed" }));
+    bool measured = false;
+    for (const Replay::EventLatency& latency : report.latencies) {
+        measured = measured || (latency.type == EventType::SquawkAssigned && latency.count == 1);
+    }
+    CHECK(measured);
+    CHECK(host.squawk().getCallsignsBySquawk("4721") == std::vector<std::string>({ "DLH1" }));
+}
+
+void testUnsubscribed(const std::filesystem::path& path)
+{
+    Replay::ReplayHost host;
+    CHECK(host.squawk().registerProvider(std::make_shared<FixedProvider>()));
+    AssigningPlugin plugin(host, { EventType::PositionUpdate });
+    Recording::RecordingReader reader;
+    CHECK(reader.open(path));
+    Replay::replay(reader, plugin, host, { 0 });
+
+    // Not delivered, but the host still tracks the assigned code
+    CHECK(plugin.assigned.empty());
+    CHECK(host.squawk().isCodeInUse("4721"));
+}
+
+} // namespace
+
+int main()
+{
+    const std::filesystem::path path = record();
+    testDelivery(path);
+    testUnsubscribed(path);
+    std::filesystem::remove(path);
+    return Testing::result();
+}
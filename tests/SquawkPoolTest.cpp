@@ -0,0 +1,103 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+using namespace PluginSDK;
+using namespace std::chrono_literals;
+
+namespace {
+
+void reserve(Squawk::SquawkAPI& squawk, const std::string& name, const std::string& first,
+    const std::string& last)
+{
+    CHECK(squawk.reserveRange({ name, first, last, {} }));
+}
+
+void testAllocation()
+{
+    Replay::ReplayHost host;
+    Squawk::SquawkAPI& squawk = host.squawk();
+    reserve(squawk, "EDDF", "0100", "0107");
+
+    // An aircraft asking again keeps its code
+    CHECK(squawk.allocateCode("EDDF", "DLH1") == std::optional<std::string>("0100"));
+    CHECK(squawk.allocateCode("EDDF", "DLH1") == std::optional<std::string>("0100"));
+    CHECK(squawk.allocateCode("EDDF", "DLH2") == std::optional<std::string>("0101"));
+
+    // Codes squawked in the snapshot are skipped
+    Recording::Snapshot snapshot;
+    Aircraft::Aircraft aircraft;
+    aircraft.callsign = "BAW1";
+    aircraft.squawk = "0102";
+    snapshot.aircraft.push_back(aircraft);
+    host.setSnapshot(snapshot);
+    CHECK(squawk.isCodeInUse("0102"));
+    CHECK(squawk.allocateCode("EDDF", "DLH3") == std::optional<std::string>("0103"));
+
+    // So are codes set by beacon code changes and squawk assignments
+    const ControllerData::AircraftBeaconCodeChangedEvent changed { "BAW1", "0102", "0104" };
+    host.trackEntities(EventType::AircraftBeaconCodeChanged, &changed);
+    CHECK(!squawk.isCodeInUse("0102"));
+    CHECK(squawk.isCodeInUse("0104"));
+    const Squawk::SquawkAssignedEvent assigned { "AFR1", "0105", "replay" };
+    host.trackEntities(EventType::SquawkAssigned, &assigned);
+    CHECK(squawk.isCodeInUse("0105"));
+    CHECK(squawk.allocateCode("EDDF", "") == std::optional<std::string>("0102"));
+    CHECK(squawk.allocateCode("EDDF", "") == std::optional<std::string>("0106"));
+    CHECK(squawk.allocateCode("EDDF", "") == std::optional<std::string>("0107"));
+    CHECK(!squawk.allocateCode("EDDF", "DLH4"));
+}
+
+void testRelease()
+{
+    Replay::ReplayHost host;
+    Squawk::SquawkAPI& squawk = host.squawk();
+    reserve(squawk, "EDDF", "0100", "0101");
+    squawk.setReleaseCooldown(60s);
+    CHECK(squawk.allocateCode("EDDF", "DLH1") == std::optional<std::string>("0100"));
+    CHECK(squawk.allocateCode("EDDF", "DLH2") == std::optional<std::string>("0101"));
+
+    // Released codes cool down before they are handed out again
+    squawk.releaseCode("0100");
+    CHECK(squawk.isCodeInUse("0100"));
+    CHECK(!squawk.allocateCode("EDDF", "DLH3"));
+    host.advanceTo(60s);
+    CHECK(!squawk.isCodeInUse("0100"));
+
+    // Disconnecting releases the aircraft's allocation
+    const Aircraft::AircraftDisconnectedEvent disconnected { "DLH2" };
+    host.trackEntities(EventType::AircraftDisconnected, &disconnected);
+    host.advanceTo(90s);
+    CHECK(squawk.isCodeInUse("0101"));
+    host.advanceTo(120s);
+    CHECK(squawk.allocateCode("EDDF", "DLH3") == std::optional<std::string>("0100"));
+    CHECK(squawk.allocateCode("EDDF", "DLH4") == std::optional<std::string>("0101"));
+}
+
+void testWordBoundary()
+{
+    Replay::ReplayHost host;
+    Squawk::SquawkAPI& squawk = host.squawk();
+    // 0770 to 1010 spans codes 504 to 520, across the word holding codes 448 to 511
+    reserve(squawk, "EGLL", "0770", "1010");
+    for (int i = 0; i < 8; ++i) {
+        CHECK(squawk.allocateCode("EGLL", ""));
+    }
+    CHECK(squawk.allocateCode("EGLL", "") == std::optional<std::string>("1000"));
+    CHECK(squawk.allocateCode("EGLL", "") == std::optional<std::string>("1001"));
+    CHECK(!squawk.isCodeInUse("0767"));
+}
+
+} // namespace
+
+int main()
+{
+    testAllocation();
+    testRelease();
+    testWordBoundary();
+    return Testing::result();
+}
@@ -0,0 +1,109 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+class RecordingProvider : public Tag::TagValueProvider {
+public:
+    void ProvideTagValues(const std::vector<Tag::TagValueRequest>& requests,
+        std::vector<Tag::TagValueUpdate>& outValues) override
+    {
+        calls.push_back(requests);
+        for (const Tag::TagValueRequest& request : requests) {
+            const std::string value = request.callsign + "-" + request.tagId;
+            outValues.push_back({ request.tagId, request.callsign, value, {}, {} });
+        }
+    }
+
+    std::vector<std::vector<Tag::TagValueRequest>> calls;
+};
+
+Recording::Snapshot fleet(const std::vector<std::string>& callsigns)
+{
+    Recording::Snapshot snapshot;
+    for (const std::string& callsign : callsigns) {
+        Aircraft::Aircraft aircraft;
+        aircraft.callsign = callsign;
+        snapshot.aircraft.push_back(aircraft);
+    }
+    return snapshot;
+}
+
+bool requested(const std::vector<Tag::TagValueRequest>& requests, const std::string& tagId,
+    const std::string& callsign)
+{
+    for (const Tag::TagValueRequest& request : requests) {
+        if (request.tagId == tagId && request.callsign == callsign) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void testPolling()
+{
+    Replay::ReplayHost host;
+    Tag::TagInterface& tags = *host.tag().getInterface();
+    const auto provider = std::make_shared<RecordingProvider>();
+    CHECK(tags.SetTagValueProvider("speed", provider));
+    CHECK(tags.SetTagValueProvider("altitude", provider));
+
+    // Nothing is visible yet
+    host.renderTags();
+    CHECK(provider->calls.empty());
+
+    // One call per provider covers every tag of every visible aircraft
+    host.setSnapshot(fleet({ "DLH1", "DLH2" }));
+    host.renderTags();
+    CHECK(provider->calls.size() == 1);
+    CHECK(provider->calls.back().size() == 4);
+    CHECK(requested(provider->calls.back(), "altitude", "DLH2"));
+
+    // Cached pairs are not polled again
+    host.renderTags();
+    CHECK(provider->calls.size() == 1);
+
+    // An invalidated pair is polled again, alone
+    tags.InvalidateTagValue("speed", "DLH1");
+    host.renderTags();
+    CHECK(provider->calls.size() == 2);
+    CHECK(provider->calls.back().size() == 1);
+    CHECK(requested(provider->calls.back(), "speed", "DLH1"));
+
+    // InvalidateTagValues drops every provided tag of one aircraft
+    tags.InvalidateTagValues("DLH2");
+    host.renderTags();
+    CHECK(provider->calls.size() == 3);
+    CHECK(provider->calls.back().size() == 2);
+    CHECK(requested(provider->calls.back(), "speed", "DLH2"));
+    CHECK(requested(provider->calls.back(), "altitude", "DLH2"));
+
+    // Aircraft appearing later are polled on the next frame
+    host.setSnapshot(fleet({ "DLH1", "DLH2", "DLH3" }));
+    host.renderTags();
+    CHECK(provider->calls.size() == 4);
+    CHECK(provider->calls.back().size() == 2);
+    CHECK(requested(provider->calls.back(), "speed", "DLH3"));
+
+    // A removed provider is no longer asked
+    CHECK(tags.RemoveTagValueProvider("speed"));
+    CHECK(tags.RemoveTagValueProvider("altitude"));
+    tags.InvalidateTagValues("DLH1");
+    host.renderTags();
+    CHECK(provider->calls.size() == 4);
+}
+
+} // namespace
+
+int main()
+{
+    testPolling();
+    return Testing::result();
+}
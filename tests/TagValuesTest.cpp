@@ -0,0 +1,64 @@
+#include "Check.h"
+
+#include "ReplayHost.h"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace PluginSDK;
+
+namespace {
+
+Tag::TagValueUpdate update(const std::string& tagId, const std::string& callsign,
+    const std::string& value, std::optional<std::array<unsigned int, 3>> colour = std::nullopt)
+{
+    return { tagId, callsign, value, colour, std::nullopt };
+}
+
+// Values and colours already shown for a tag and aircraft are dropped
+void testDeduplication()
+{
+    Replay::ReplayHost host;
+    Tag::TagInterface& tags = *host.tag().getInterface();
+
+    const Tag::TagValueUpdateResult first = tags.UpdateTagValues({
+        update("speed", "DLH1", "250"),
+        update("speed", "DLH2", "250"),
+        update("speed", "DLH1", "250"),
+        update("altitude", "DLH1", "FL120"),
+    });
+    CHECK(first.applied == 3);
+    CHECK(first.unchanged == 1);
+    CHECK(first.failed == 0);
+
+    const Tag::TagValueUpdateResult second = tags.UpdateTagValues({
+        update("speed", "DLH1", "250"),
+        update("speed", "DLH2", "260"),
+        update("altitude", "DLH1", "FL120", std::array<unsigned int, 3> { 255, 0, 0 }),
+        update("altitude", "DLH1", "FL120", std::array<unsigned int, 3> { 255, 0, 0 }),
+    });
+    CHECK(second.applied == 2);
+    CHECK(second.unchanged == 2);
+
+    const Tag::TagValueUpdateResult invalid
+        = tags.UpdateTagValues({ update("", "DLH1", "1"), update("speed", "", "1") });
+    CHECK(invalid.failed == 2);
+    CHECK(invalid.applied == 0);
+
+    // The single-value call shares the same cache
+    Tag::TagContext context;
+    context.callsign = "DLH2";
+    CHECK(tags.UpdateTagValue("speed", "260", context));
+    CHECK(tags.UpdateTagValues({ update("speed", "DLH2", "260") }).unchanged == 1);
+    CHECK(host.counters().tagUpdates == 12);
+}
+
+} // namespace
+
+int main()
+{
+    testDeduplication();
+    return Testing::result();
+}
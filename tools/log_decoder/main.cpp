@@ -0,0 +1,342 @@
+// neoradar-logdecode - converts binary plugin logs (.nrbl) to text or JSON lines
+//
+// Usage: neoradar-logdecode [--json] <file.nrbl>...
+
+#include <NeoRadarSDK/BinaryLog.h>
+#include <NeoRadarSDK/Logger.h>
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace PluginSDK::Logger;
+
+namespace {
+
+struct FormatEntry {
+    LogLevel level;
+    std::string format;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::vector<char>& data)
+        : m_data(data)
+    {
+    }
+
+    bool atEnd() const { return m_offset >= m_data.size(); }
+
+    template <typename T> bool read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (m_data.size() - m_offset < sizeof(T)) {
+            return false;
+        }
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+            value = readLittleEndian<T>(m_data.data() + m_offset);
+        } else {
+            std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+        }
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool readString(std::size_t length, std::string& value)
+    {
+        if (m_data.size() - m_offset < length) {
+            return false;
+        }
+        value.assign(m_data.data() + m_offset, length);
+        m_offset += length;
+        return true;
+    }
+
+private:
+    const std::vector<char>& m_data;
+    std::size_t m_offset = 0;
+};
+
+const char* levelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Fatal:
+        return "fatal";
+    case LogLevel::Error:
+        return "error";
+    case LogLevel::Warning:
+        return "warning";
+    case LogLevel::Info:
+        return "info";
+    case LogLevel::Debug:
+        return "debug";
+    case LogLevel::Verbose:
+        return "verbose";
+    }
+    return "unknown";
+}
+
+std::string formatTimestamp(std::uint64_t nanoseconds)
+{
+    const std::time_t seconds = static_cast<std::time_t>(nanoseconds / 1000000000ull);
+    std::tm utc {};
+#if defined(_WIN32)
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+    char buffer[40];
+    const std::size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%06lluZ",
+        static_cast<unsigned long long>((nanoseconds % 1000000000ull) / 1000));
+    return buffer;
+}
+
+std::string jsonEscape(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size() + 2);
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char code[8];
+                std::snprintf(code, sizeof(code), "\\u%04x", c);
+                escaped += code;
+            } else {
+                escaped += c;
+            }
+        }
+    }
+    return escaped;
+}
+
+struct DecodedArgument {
+    LogArgumentType type;
+    std::string text;
+};
+
+bool readArgument(Reader& reader, DecodedArgument& argument)
+{
+    std::uint8_t type = 0;
+    if (!reader.read(type)) {
+        return false;
+    }
+    argument.type = static_cast<LogArgumentType>(type);
+    std::ostringstream out;
+    switch (argument.type) {
+    case LogArgumentType::Int: {
+        std::int64_t value = 0;
+        if (!reader.read(value)) {
+            return false;
+        }
+        out << value;
+        break;
+    }
+    case LogArgumentType::UInt: {
+        std::uint64_t value = 0;
+        if (!reader.read(value)) {
+            return false;
+        }
+        out << value;
+        break;
+    }
+    case LogArgumentType::Double: {
+        double value = 0.0;
+        if (!reader.read(value)) {
+            return false;
+        }
+        out << value;
+        break;
+    }
+    case LogArgumentType::Bool: {
+        std::uint8_t value = 0;
+        if (!reader.read(value)) {
+            return false;
+        }
+        out << (value ? "true" : "false");
+        break;
+    }
+    case LogArgumentType::String: {
+        std::uint16_t length = 0;
+        std::string value;
+        if (!reader.read(length) || !reader.readString(length, value)) {
+            return false;
+        }
+        argument.text = std::move(value);
+        return true;
+    }
+    default:
+        return false;
+    }
+    argument.text = out.str();
+    return true;
+}
+
+std::string substitute(const std::string& format, const std::vector<DecodedArgument>& arguments)
+{
+    std::string message;
+    std::size_t next = 0;
+    std::size_t position = 0;
+    while (position < format.size()) {
+        const std::size_t placeholder = format.find("{}", position);
+        if (placeholder == std::string::npos || next == arguments.size()) {
+            break;
+        }
+        message.append(format, position, placeholder - position);
+        message += arguments[next++].text;
+        position = placeholder + 2;
+    }
+    message.append(format, position, std::string::npos);
+    return message;
+}
+
+bool decodeFile(const std::string& path, bool json)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << path << ": cannot open file\n";
+        return false;
+    }
+    const std::vector<char> data(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Reader reader(data);
+
+    char magic[4] = {};
+    std::uint16_t version = 0;
+    std::uint16_t reserved = 0;
+    std::uint64_t created = 0;
+    if (!reader.read(magic) || std::memcmp(magic, BinaryLogMagic, sizeof(magic)) != 0
+        || !reader.read(version) || !reader.read(reserved) || !reader.read(created)) {
+        std::cerr << path << ": not a binary log file\n";
+        return false;
+    }
+    if (version != BinaryLogVersion) {
+        std::cerr << path << ": unsupported version " << version << "\n";
+        return false;
+    }
+
+    std::unordered_map<LogFormatId, FormatEntry> formats;
+    std::vector<DecodedArgument> arguments;
+    while (!reader.atEnd()) {
+        std::uint8_t recordType = 0;
+        reader.read(recordType);
+        switch (static_cast<BinaryLogRecordType>(recordType)) {
+        case BinaryLogRecordType::End:
+            return true;
+        case BinaryLogRecordType::Format: {
+            LogFormatId id = 0;
+            std::uint8_t level = 0;
+            std::uint16_t length = 0;
+            FormatEntry entry;
+            if (!reader.read(id) || !reader.read(level) || !reader.read(length)
+                || !reader.readString(length, entry.format)) {
+                std::cerr << path << ": truncated format record\n";
+                return false;
+            }
+            entry.level = static_cast<LogLevel>(level);
+            formats[id] = std::move(entry);
+            break;
+        }
+        case BinaryLogRecordType::Message: {
+            LogFormatId id = 0;
+            std::uint64_t timestamp = 0;
+            std::uint8_t count = 0;
+            if (!reader.read(id) || !reader.read(timestamp) || !reader.read(count)) {
+                std::cerr << path << ": truncated message record\n";
+                return false;
+            }
+            arguments.resize(count);
+            for (DecodedArgument& argument : arguments) {
+                if (!readArgument(reader, argument)) {
+                    std::cerr << path << ": malformed argument\n";
+                    return false;
+                }
+            }
+
+            const auto format = formats.find(id);
+            const std::string message = format != formats.end()
+                ? substitute(format->second.format, arguments)
+                : "<unknown format " + std::to_string(id) + ">";
+            const char* level = format != formats.end() ? levelName(format->second.level) : "unknown";
+
+            if (json) {
+                std::cout << "{\"time\":\"" << formatTimestamp(timestamp) << "\",\"level\":\""
+                          << level << "\",\"formatId\":" << id << ",\"message\":\""
+                          << jsonEscape(message) << "\",\"args\":[";
+                for (std::size_t i = 0; i < arguments.size(); ++i) {
+                    if (i > 0) {
+                        std::cout << ',';
+                    }
+                    if (arguments[i].type == LogArgumentType::String) {
+                        std::cout << '"' << jsonEscape(arguments[i].text) << '"';
+                    } else {
+                        std::cout << arguments[i].text;
+                    }
+                }
+                std::cout << "]}\n";
+            } else {
+                std::cout << formatTimestamp(timestamp) << " [" << level << "] " << message
+                          << "\n";
+            }
+            break;
+        }
+        default:
+            std::cerr << path << ": unknown record type " << int(recordType) << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool json = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--json") {
+            json = true;
+        } else if (argument == "-h" || argument == "--help") {
+            std::cout << "Usage: " << argv[0] << " [--json] <file.nrbl>...\n";
+            return 0;
+        } else {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--json] <file.nrbl>...\n";
+        return 2;
+    }
+
+    bool ok = true;
+    for (const std::string& path : paths) {
+        ok = decodeFile(path, json) && ok;
+    }
+    return ok ? 0 : 1;
+}
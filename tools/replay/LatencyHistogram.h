@@ -0,0 +1,111 @@
+#pragma once
+#include <NeoRadarSDK/Metrics.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace PluginSDK::Replay {
+
+// Log-linear histogram of durations, recorded without locks. Values below
+// SubBuckets are exact; above, each power of two is split into SubBuckets
+// buckets, so percentiles are within 1 / (2 * SubBuckets) of the exact value.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SubBucketBits = 4;
+    static constexpr std::uint64_t SubBuckets = 1u << SubBucketBits;
+    // Larger values share the last power of two; max stays exact
+    static constexpr unsigned MaxBits = 48;
+    static constexpr std::size_t BucketCount = (MaxBits - SubBucketBits + 1) * SubBuckets;
+
+    void record(std::uint64_t value)
+    {
+        m_buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_total.fetch_add(value, std::memory_order_relaxed);
+        std::uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void reset()
+    {
+        for (auto& bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_total.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+    // Values are converted to nanoseconds by the given factor
+    Metrics::LatencySummary summary(double nanosecondsPerUnit = 1.0) const
+    {
+        const auto toNanoseconds = [nanosecondsPerUnit](double value) {
+            return std::chrono::nanoseconds(static_cast<std::int64_t>(value * nanosecondsPerUnit));
+        };
+        Metrics::LatencySummary summary;
+        summary.count = count();
+        summary.total = toNanoseconds(static_cast<double>(m_total.load(std::memory_order_relaxed)));
+        summary.max = toNanoseconds(static_cast<double>(m_max.load(std::memory_order_relaxed)));
+        if (summary.count == 0) {
+            return summary;
+        }
+
+        const std::uint64_t p50Rank = (summary.count + 1) / 2;
+        const std::uint64_t p99Rank = summary.count - summary.count / 100;
+        std::uint64_t seen = 0;
+        bool p50Found = false;
+        for (std::size_t index = 0; index < BucketCount; ++index) {
+            seen += m_buckets[index].load(std::memory_order_relaxed);
+            if (!p50Found && seen >= p50Rank) {
+                summary.p50 = std::min(toNanoseconds(midpoint(index)), summary.max);
+                p50Found = true;
+            }
+            if (seen >= p99Rank) {
+                summary.p99 = std::min(toNanoseconds(midpoint(index)), summary.max);
+                break;
+            }
+        }
+        return summary;
+    }
+
+    // Index of the bucket counting value
+    static std::size_t bucket(std::uint64_t value)
+    {
+        if (value < SubBuckets) {
+            return static_cast<std::size_t>(value);
+        }
+        value = std::min<std::uint64_t>(value, (std::uint64_t(1) << MaxBits) - 1);
+        unsigned exponent = 0;
+        while (value >> (exponent + 1)) {
+            ++exponent;
+        }
+        const unsigned shift = exponent - SubBucketBits;
+        return (shift + 1) * SubBuckets + ((value >> shift) & (SubBuckets - 1));
+    }
+
+    // Value percentiles report for a bucket
+    static double midpoint(std::size_t index)
+    {
+        if (index < SubBuckets) {
+            return static_cast<double>(index);
+        }
+        const unsigned shift = static_cast<unsigned>(index / SubBuckets) - 1;
+        const std::uint64_t lower = (SubBuckets + index % SubBuckets) << shift;
+        return static_cast<double>(lower) + static_cast<double>(std::uint64_t(1) << shift) / 2;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, BucketCount> m_buckets {};
+    std::atomic<std::uint64_t> m_count { 0 };
+    std::atomic<std::uint64_t> m_total { 0 };
+    std::atomic<std::uint64_t> m_max { 0 };
+};
+
+} // namespace PluginSDK::Replay
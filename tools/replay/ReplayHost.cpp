@@ -0,0 +1,4331 @@
+#include "ReplayHost.h"
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <regex>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace PluginSDK::Replay {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string toLower(std::string_view text)
+{
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+bool isWordCharacter(char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0; }
+
+// Case-insensitive whole-word search
+bool containsWord(std::string_view text, std::string_view word)
+{
+    if (word.empty()) {
+        return false;
+    }
+    const std::string haystack = toLower(text);
+    const std::string needle = toLower(word);
+    for (auto position = haystack.find(needle); position != std::string::npos;
+         position = haystack.find(needle, position + 1)) {
+        const auto end = position + needle.size();
+        if ((position == 0 || !isWordCharacter(haystack[position - 1]))
+            && (end == haystack.size() || !isWordCharacter(haystack[end]))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Four octal digits
+constexpr std::size_t SquawkCodeCount = 4096;
+
+std::optional<int> parseSquawk(const std::string& code)
+{
+    if (code.size() != 4) {
+        return std::nullopt;
+    }
+    int value = 0;
+    for (char c : code) {
+        if (c < '0' || c > '7') {
+            return std::nullopt;
+        }
+        value = value * 8 + (c - '0');
+    }
+    return value;
+}
+
+std::string formatSquawk(int value)
+{
+    std::string code(4, '0');
+    for (int i = 3; i >= 0; --i) {
+        code[i] = static_cast<char>('0' + (value & 7));
+        value >>= 3;
+    }
+    return code;
+}
+
+double distanceNm(double lat1, double lon1, double lat2, double lon2)
+{
+    constexpr double radians = 3.14159265358979323846 / 180.0;
+    const double dLat = (lat2 - lat1) * radians;
+    const double dLon = (lon2 - lon1) * radians;
+    const double a = std::sin(dLat / 2) * std::sin(dLat / 2)
+        + std::cos(lat1 * radians) * std::cos(lat2 * radians) * std::sin(dLon / 2)
+            * std::sin(dLon / 2);
+    return 3440.065 * 2 * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+}
+
+template <typename Base> class Token : public Base {
+public:
+    explicit Token(std::function<void()> release)
+        : m_release(std::move(release))
+    {
+    }
+    ~Token() override
+    {
+        if (m_release) {
+            m_release();
+        }
+    }
+
+private:
+    std::function<void()> m_release;
+};
+
+struct MessageSubscription {
+    std::uint64_t id;
+    Chat::MessageChannel channel;
+    Chat::MessageFilter filter;
+    std::optional<std::regex> pattern;
+};
+
+struct ReceivedMessage {
+    Chat::MessageChannel channel;
+    const std::string* sentFrom = nullptr;
+    const std::string* sentTo = nullptr;
+    const std::string* message = nullptr;
+    const std::vector<int>* frequencies = nullptr;
+    bool fromMe = false;
+};
+
+std::optional<ReceivedMessage> toReceivedMessage(EventType type, const void* event)
+{
+    ReceivedMessage received;
+    switch (type) {
+    case EventType::FrequencyMessageReceived: {
+        const auto& e = *static_cast<const Chat::FrequencyMessageReceivedEvent*>(event);
+        received = { Chat::MessageChannel::Frequency, &e.sentFrom, nullptr, &e.message,
+            &e.frequencies, e.fromMe };
+        break;
+    }
+    case EventType::PrivateMessageReceived: {
+        const auto& e = *static_cast<const Chat::PrivateMessageReceivedEvent*>(event);
+        received = { Chat::MessageChannel::Private, &e.sentFrom, &e.sentTo, &e.message, nullptr,
+            e.fromMe };
+        break;
+    }
+    case EventType::BroadcastMessageReceived: {
+        const auto& e = *static_cast<const Chat::BroadcastMessageReceivedEvent*>(event);
+        received = { Chat::MessageChannel::Broadcast, &e.sentFrom, nullptr, &e.message, nullptr,
+            e.fromMe };
+        break;
+    }
+    case EventType::SupervisorMessageReceived: {
+        const auto& e = *static_cast<const Chat::SupervisorMessageReceivedEvent*>(event);
+        received = { Chat::MessageChannel::Supervisor, &e.sentFrom, nullptr, &e.message,
+            nullptr, e.fromMe };
+        break;
+    }
+    case EventType::ServerMessageReceived: {
+        const auto& e = *static_cast<const Chat::ServerMessageReceivedEvent*>(event);
+        received = { Chat::MessageChannel::Server, &e.sentFrom, nullptr, &e.message };
+        break;
+    }
+    case EventType::AtcMessageReceived: {
+        const auto& e = *static_cast<const Chat::AtcMessageReceivedEvent*>(event);
+        received = { Chat::MessageChannel::Atc, &e.sentFrom, nullptr, &e.message };
+        break;
+    }
+    default:
+        return std::nullopt;
+    }
+    return received;
+}
+
+bool matches(const MessageSubscription& subscription, const ReceivedMessage& message)
+{
+    const Chat::MessageFilter& filter = subscription.filter;
+    if (subscription.channel != message.channel) {
+        return false;
+    }
+    if (!filter.frequencies.empty()) {
+        if (!message.frequencies
+            || std::none_of(message.frequencies->begin(), message.frequencies->end(),
+                [&](int frequency) {
+                    return std::find(filter.frequencies.begin(), filter.frequencies.end(),
+                               frequency)
+                        != filter.frequencies.end();
+                })) {
+            return false;
+        }
+    }
+    if (!filter.senderPrefixes.empty()
+        && std::none_of(filter.senderPrefixes.begin(), filter.senderPrefixes.end(),
+            [&](const std::string& prefix) { return message.sentFrom->rfind(prefix, 0) == 0; })) {
+        return false;
+    }
+    if (!filter.keywords.empty()
+        && std::none_of(filter.keywords.begin(), filter.keywords.end(),
+            [&](const std::string& keyword) { return containsWord(*message.message, keyword); })) {
+        return false;
+    }
+    return !subscription.pattern || std::regex_search(*message.message, *subscription.pattern);
+}
+
+// Lowercase runs of word characters, as containsWord delimits them
+template <typename Function> void forEachWord(std::string_view text, Function&& function)
+{
+    for (std::size_t begin = 0; begin < text.size();) {
+        if (!isWordCharacter(text[begin])) {
+            ++begin;
+            continue;
+        }
+        std::size_t end = begin;
+        while (end < text.size() && isWordCharacter(text[end])) {
+            ++end;
+        }
+        function(toLower(text.substr(begin, end - begin)));
+        begin = end;
+    }
+}
+
+// Chat history: one ring buffer per channel, with an index from every word of
+// a message's sender, recipient and text to the messages containing it
+class ChatHistory {
+public:
+    static constexpr std::size_t ChannelCapacity = 1024;
+    static constexpr std::size_t ChannelCount = 6;
+
+    void add(Chat::ChatHistoryEntry entry)
+    {
+        Channel& channel = m_channels[static_cast<std::size_t>(entry.channel)];
+        if (channel.entries.size() == ChannelCapacity) {
+            evict(channel);
+        }
+        forEachEntryWord(entry, [&](std::string word) {
+            auto& sequences = channel.words[std::move(word)];
+            if (sequences.empty() || sequences.back() != entry.sequence) {
+                sequences.push_back(entry.sequence);
+            }
+        });
+        channel.entries.push_back(std::move(entry));
+    }
+
+    // Matching entries, newest first
+    std::vector<Chat::ChatHistoryEntry> query(const Chat::ChatHistoryQuery& query) const
+    {
+        std::vector<const Chat::ChatHistoryEntry*> matches;
+        for (std::size_t index = 0; index < ChannelCount; ++index) {
+            if (!query.channel || static_cast<std::size_t>(*query.channel) == index) {
+                collect(m_channels[index], query, matches);
+            }
+        }
+        std::sort(matches.begin(), matches.end(),
+            [](const auto* a, const auto* b) { return a->sequence > b->sequence; });
+        matches.resize(std::min(matches.size(), query.limit));
+
+        std::vector<Chat::ChatHistoryEntry> entries;
+        entries.reserve(matches.size());
+        for (const Chat::ChatHistoryEntry* entry : matches) {
+            entries.push_back(*entry);
+        }
+        return entries;
+    }
+
+private:
+    struct Channel {
+        std::deque<Chat::ChatHistoryEntry> entries;
+        // Sequences of the entries containing each word, oldest first
+        std::unordered_map<std::string, std::deque<std::uint64_t>> words;
+    };
+
+    template <typename Function>
+    static void forEachEntryWord(const Chat::ChatHistoryEntry& entry, Function&& function)
+    {
+        forEachWord(entry.sentFrom, function);
+        forEachWord(entry.sentTo, function);
+        forEachWord(entry.message, function);
+    }
+
+    // The oldest entry is at the front of every list it is in
+    static void evict(Channel& channel)
+    {
+        const Chat::ChatHistoryEntry& oldest = channel.entries.front();
+        forEachEntryWord(oldest, [&](const std::string& word) {
+            const auto it = channel.words.find(word);
+            if (it == channel.words.end() || it->second.front() != oldest.sequence) {
+                return;
+            }
+            it->second.pop_front();
+            if (it->second.empty()) {
+                channel.words.erase(it);
+            }
+        });
+        channel.entries.pop_front();
+    }
+
+    static bool accepts(const Chat::ChatHistoryEntry& entry, const Chat::ChatHistoryQuery& query)
+    {
+        return (!query.beforeSequence || entry.sequence < *query.beforeSequence)
+            && (!query.frequency
+                || std::find(entry.frequencies.begin(), entry.frequencies.end(), *query.frequency)
+                    != entry.frequencies.end())
+            && (!query.keyword || containsWord(entry.message, *query.keyword))
+            && (!query.callsign || entry.sentFrom == *query.callsign
+                || entry.sentTo == *query.callsign
+                || containsWord(entry.message, *query.callsign));
+    }
+
+    // Any match of a whole-word or exact search for term contains the first word of term
+    static std::optional<std::string> indexWord(const std::optional<std::string>& term)
+    {
+        if (!term || term->empty() || !isWordCharacter(term->front())) {
+            return std::nullopt;
+        }
+        const auto end = std::find_if_not(term->begin(), term->end(), isWordCharacter);
+        return toLower(std::string_view(*term).substr(0, end - term->begin()));
+    }
+
+    // Up to query.limit matches of one channel, visiting only indexed
+    // candidates when the query names a keyword or callsign
+    static void collect(const Channel& channel, const Chat::ChatHistoryQuery& query,
+        std::vector<const Chat::ChatHistoryEntry*>& matches)
+    {
+        std::size_t found = 0;
+        const auto visit = [&](const Chat::ChatHistoryEntry& entry) {
+            if (accepts(entry, query)) {
+                matches.push_back(&entry);
+                ++found;
+            }
+            return found < query.limit;
+        };
+
+        std::optional<std::string> word = indexWord(query.keyword);
+        if (!word) {
+            word = indexWord(query.callsign);
+        }
+        if (!word) {
+            for (auto it = channel.entries.rbegin(); it != channel.entries.rend() && visit(*it);
+                 ++it) {
+            }
+            return;
+        }
+
+        const auto list = channel.words.find(*word);
+        if (list == channel.words.end()) {
+            return;
+        }
+        for (auto sequence = list->second.rbegin(); sequence != list->second.rend(); ++sequence) {
+            const auto entry = std::lower_bound(channel.entries.begin(), channel.entries.end(),
+                *sequence, [](const Chat::ChatHistoryEntry& e, std::uint64_t value) {
+                    return e.sequence < value;
+                });
+            if (!visit(*entry)) {
+                return;
+            }
+        }
+    }
+
+    std::array<Channel, ChannelCount> m_channels;
+};
+
+// Squawk assignment, with owned copies of its aircraft so a provider that
+// misses its deadline can finish after the snapshot changed
+struct SquawkJob {
+    std::vector<std::string> callsigns;
+    std::vector<Aircraft::Aircraft> aircraft;
+    std::vector<Flightplan::Flightplan> flightplans;
+    // In the order they are asked
+    std::vector<std::shared_ptr<Squawk::SquawkProviderInterface>> providers;
+    std::chrono::milliseconds deadline { 0 };
+};
+
+struct QueuedClientMessage {
+    Chat::ClientTextMessageEvent message;
+    // Recording time the first merged message was queued
+    std::chrono::nanoseconds queued;
+};
+
+struct RegisteredCommand {
+    std::string id;
+    Chat::CommandDefinition definition;
+    std::shared_ptr<Chat::CommandProvider> provider;
+};
+
+bool isReservedCommand(const std::string& name)
+{
+    static const char* const reserved[] = { "hello", "wx", "clear", "dev", "rings", "vis",
+        "wallop", "chat", "center" };
+    return std::find(std::begin(reserved), std::end(reserved), name) != std::end(reserved);
+}
+
+// Checked once at registration, so parsing can rely on it
+bool isValidDefinition(const Chat::CommandDefinition& definition)
+{
+    bool optionalSeen = false;
+    for (const Chat::CommandParameter& parameter : definition.parameters) {
+        if (parameter.name.empty() || parameter.length < 0 || parameter.minLength < 0
+            || parameter.maxLength < 0
+            || (parameter.maxLength > 0 && parameter.minLength > parameter.maxLength)
+            || (parameter.required && optionalSeen)) {
+            return false;
+        }
+        optionalSeen = optionalSeen || !parameter.required;
+    }
+    return true;
+}
+
+bool isSpace(char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; }
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+std::optional<bool> parseBoolean(std::string_view text)
+{
+    const std::string value = toLower(text);
+    if (value == "true" || value == "yes" || value == "on" || value == "1") {
+        return true;
+    }
+    if (value == "false" || value == "no" || value == "off" || value == "0") {
+        return false;
+    }
+    return std::nullopt;
+}
+
+// Split the arguments of a command line and check them against the command's
+// parameters; returns the reason they were rejected, if any
+std::optional<std::string> parseArguments(const Chat::CommandDefinition& definition,
+    std::string_view text, std::vector<Chat::CommandArgument>& arguments)
+{
+    const auto& parameters = definition.parameters;
+    text = trim(text);
+    while (!text.empty()) {
+        if (arguments.size() == parameters.size()) {
+            return "too many arguments";
+        }
+        std::string_view argument = text;
+        if (arguments.size() + 1 < parameters.size() || !definition.lastParameterHasSpaces) {
+            const auto end = std::find_if(text.begin(), text.end(), isSpace);
+            argument = text.substr(0, static_cast<std::size_t>(end - text.begin()));
+        }
+        text = trim(text.substr(argument.size()));
+
+        const Chat::CommandParameter& parameter = parameters[arguments.size()];
+        const auto length = static_cast<int>(argument.size());
+        if ((parameter.length > 0 && length != parameter.length)
+            || length < parameter.minLength
+            || (parameter.maxLength > 0 && length > parameter.maxLength)) {
+            return parameter.name + ": invalid length";
+        }
+        Chat::CommandArgument parsed { parameter.type, argument };
+        if (parameter.type == Chat::ParameterType::Number) {
+            // from_chars ignores the locale and rejects hex floats; inf and nan
+            // parse but are no numbers a command can act on
+            const char* last = argument.data() + argument.size();
+            const auto [end, error] = std::from_chars(argument.data(), last, parsed.number);
+            if (error != std::errc() || end != last || !std::isfinite(parsed.number)) {
+                return parameter.name + ": not a number";
+            }
+        } else if (parameter.type == Chat::ParameterType::Boolean) {
+            const std::optional<bool> value = parseBoolean(argument);
+            if (!value) {
+                return parameter.name + ": not a boolean";
+            }
+            parsed.boolean = *value;
+        }
+        arguments.push_back(parsed);
+    }
+    if (arguments.size() < parameters.size() && parameters[arguments.size()].required) {
+        return parameters[arguments.size()].name + ": missing";
+    }
+    return std::nullopt;
+}
+
+// Components is a const or mutable std::vector<Tag::DropdownComponent>
+template <typename Components>
+bool findComponent(
+    Components& components, const std::string& id, Components*& parent, std::size_t& index)
+{
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        if (components[i].id == id) {
+            parent = &components;
+            index = i;
+            return true;
+        }
+        if (findComponent(components[i].children, id, parent, index)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool applyPatch(Tag::DropdownDefinition& dropdown, const Tag::DropdownPatch& patch)
+{
+    std::vector<Tag::DropdownComponent>* parent = nullptr;
+    std::size_t index = 0;
+    if (!findComponent(dropdown.components, patch.componentId, parent, index)) {
+        return false;
+    }
+    Tag::DropdownComponent& component = (*parent)[index];
+    switch (patch.type) {
+    case Tag::DropdownPatchType::SetText:
+        component.text = patch.text;
+        return true;
+    case Tag::DropdownPatchType::SetChecked:
+        component.data[Tag::DropdownCheckedKey] = patch.checked ? "true" : "false";
+        return true;
+    case Tag::DropdownPatchType::InsertChild: {
+        if (!patch.child) {
+            return false;
+        }
+        auto& children = component.children;
+        const std::size_t position
+            = std::min(patch.index.value_or(children.size()), children.size());
+        children.insert(children.begin() + static_cast<std::ptrdiff_t>(position), *patch.child);
+        return true;
+    }
+    case Tag::DropdownPatchType::RemoveComponent:
+        parent->erase(parent->begin() + static_cast<std::ptrdiff_t>(index));
+        return true;
+    }
+    return false;
+}
+
+class IsolatedDispatcher;
+
+// ScrollArea whose rows come from a DropdownItemSource, with the rows fetched
+// the last time its dropdown was shown
+struct VirtualScrollArea {
+    Tag::VirtualScrollAreaDefinition definition;
+    std::shared_ptr<Tag::DropdownItemSource> source;
+    // Callsign the cached rows were fetched for; empty when invalidated
+    std::string callsign;
+    std::size_t itemCount = 0;
+    std::vector<Tag::DropdownComponent> rows;
+};
+
+struct EventWaiter {
+    std::function<bool(const void*)> filter;
+    std::function<void(const void*)> callback;
+};
+
+struct Timer {
+    std::chrono::nanoseconds interval;
+    std::chrono::nanoseconds deadline;
+    std::function<void()> task;
+    bool repeat;
+    // Run instead of task if the host cancels a waitForDelay
+    std::function<void()> cancel;
+};
+
+using LogFormats = std::vector<std::pair<Logger::LogLevel, std::string>>;
+
+// Writes structured log records to rotating .nrbl files (see BinaryLog.h)
+class BinaryLogWriter {
+public:
+    ~BinaryLogWriter() { close(); }
+
+    bool open(const Logger::BinaryLogOptions& options, const LogFormats& formats)
+    {
+        close();
+        m_options = options;
+        if (m_options.directory.empty()) {
+            m_options.directory = std::filesystem::current_path();
+        }
+        m_options.maxFiles = std::max<std::size_t>(m_options.maxFiles, 1);
+        std::error_code error;
+        std::filesystem::create_directories(m_options.directory, error);
+        m_files.clear();
+        m_sequence = 0;
+        return startFile(formats);
+    }
+
+    void close()
+    {
+        if (m_file.is_open()) {
+            m_file.put(static_cast<char>(Logger::BinaryLogRecordType::End));
+            m_file.close();
+        }
+    }
+
+    bool isOpen() const { return m_file.is_open(); }
+
+    bool writeFormat(Logger::LogFormatId id, Logger::LogLevel level, std::string_view format)
+    {
+        m_record.clear();
+        encodeFormat(id, level, format);
+        return flush();
+    }
+
+    bool writeMessage(Logger::LogFormatId id, const Logger::LogArgument* args, std::size_t count,
+        const LogFormats& formats)
+    {
+        if (m_size >= m_options.maxFileSize && !startFile(formats)) {
+            return false;
+        }
+        m_record.clear();
+        Logger::writeLittleEndian(m_record, Logger::BinaryLogRecordType::Message);
+        Logger::writeLittleEndian(m_record, id);
+        Logger::writeLittleEndian(m_record, nowSinceEpoch());
+        const std::size_t written = std::min<std::size_t>(count, UINT8_MAX);
+        Logger::writeLittleEndian(m_record, static_cast<std::uint8_t>(written));
+        for (std::size_t i = 0; i < written; ++i) {
+            const Logger::LogArgument& arg = args[i];
+            Logger::writeLittleEndian(m_record, arg.type);
+            switch (arg.type) {
+            case Logger::LogArgumentType::Int:
+                Logger::writeLittleEndian(m_record, arg.i);
+                break;
+            case Logger::LogArgumentType::UInt:
+                Logger::writeLittleEndian(m_record, arg.u);
+                break;
+            case Logger::LogArgumentType::Double:
+                Logger::writeLittleEndian(m_record, arg.d);
+                break;
+            case Logger::LogArgumentType::Bool:
+                Logger::writeLittleEndian(m_record, static_cast<std::uint8_t>(arg.b));
+                break;
+            case Logger::LogArgumentType::String:
+                encodeString(arg.s);
+                break;
+            }
+        }
+        return flush();
+    }
+
+private:
+    static std::uint64_t nowSinceEpoch()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+                .count());
+    }
+
+    void encodeString(std::string_view text)
+    {
+        const std::size_t length = std::min<std::size_t>(text.size(), UINT16_MAX);
+        Logger::writeLittleEndian(m_record, static_cast<std::uint16_t>(length));
+        m_record.append(text.data(), length);
+    }
+
+    void encodeFormat(Logger::LogFormatId id, Logger::LogLevel level, std::string_view format)
+    {
+        Logger::writeLittleEndian(m_record, Logger::BinaryLogRecordType::Format);
+        Logger::writeLittleEndian(m_record, id);
+        Logger::writeLittleEndian(m_record, static_cast<std::uint8_t>(level));
+        encodeString(format);
+    }
+
+    // Closes the current file and starts the next one, deleting the oldest
+    // beyond maxFiles. Each file repeats the formats so it decodes on its own.
+    bool startFile(const LogFormats& formats)
+    {
+        close();
+        std::ostringstream name;
+        name << "replay-" << std::setw(4) << std::setfill('0') << m_sequence++ << ".nrbl";
+        const std::filesystem::path path = m_options.directory / name.str();
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file) {
+            return false;
+        }
+        m_files.push_back(path);
+        while (m_files.size() > m_options.maxFiles) {
+            std::error_code error;
+            std::filesystem::remove(m_files.front(), error);
+            m_files.pop_front();
+        }
+
+        m_size = 0;
+        m_record.assign(Logger::BinaryLogMagic, sizeof(Logger::BinaryLogMagic));
+        Logger::writeLittleEndian(m_record, Logger::BinaryLogVersion);
+        Logger::writeLittleEndian(m_record, std::uint16_t(0));
+        Logger::writeLittleEndian(m_record, nowSinceEpoch());
+        for (std::size_t id = 0; id < formats.size(); ++id) {
+            encodeFormat(static_cast<Logger::LogFormatId>(id), formats[id].first,
+                formats[id].second);
+        }
+        return flush();
+    }
+
+    bool flush()
+    {
+        if (!m_file) {
+            return false;
+        }
+        m_file.write(m_record.data(), static_cast<std::streamsize>(m_record.size()));
+        m_size += m_record.size();
+        return static_cast<bool>(m_file);
+    }
+
+    Logger::BinaryLogOptions m_options;
+    std::ofstream m_file;
+    std::deque<std::filesystem::path> m_files;
+    std::size_t m_sequence = 0;
+    std::size_t m_size = 0;
+    std::string m_record;
+};
+
+// Text log lines go through a bounded lock-free queue (one slot sequence per
+// position, as in Vyukov's bounded queue) to a writer thread, so logging never
+// waits on stderr. Lines pushed while the queue is full are dropped and counted.
+class LogQueue {
+public:
+    static constexpr std::size_t Capacity = 4096;
+
+    LogQueue()
+        : m_slots(std::make_unique<Slot[]>(Capacity))
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_writer = std::thread([this] { run(); });
+    }
+
+    ~LogQueue()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_writer.join();
+    }
+
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+
+    // Safe from any thread; false if the line was dropped
+    bool push(std::string line)
+    {
+        std::size_t position = m_tail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &m_slots[position % Capacity];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (m_tail.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (sequence < position) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->line = std::move(line);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        m_wake.notify_one();
+        return true;
+    }
+
+    std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // Wait until every line pushed so far is written
+    void flush()
+    {
+        const std::size_t pushed = m_tail.load(std::memory_order_acquire);
+        std::unique_lock lock(m_mutex);
+        m_wake.notify_one();
+        m_written.wait(lock, [&] { return m_head.load(std::memory_order_acquire) >= pushed; });
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::string line;
+    };
+
+    // Writer thread only
+    bool pop(std::string& out)
+    {
+        const std::size_t position = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[position % Capacity];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        out += slot.line;
+        out += '\n';
+        slot.line.clear();
+        slot.sequence.store(position + Capacity, std::memory_order_release);
+        m_head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    void run()
+    {
+        std::string lines;
+        for (;;) {
+            while (pop(lines)) {
+            }
+            if (!lines.empty()) {
+                std::cerr << lines << std::flush;
+                lines.clear();
+            }
+            std::unique_lock lock(m_mutex);
+            m_written.notify_all();
+            if (m_stopping && m_head.load() == m_tail.load()) {
+                return;
+            }
+            // Producers notify without the mutex, so a wakeup can be missed
+            m_wake.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<std::size_t> m_tail { 0 };
+    std::atomic<std::size_t> m_head { 0 };
+    std::atomic<std::uint64_t> m_dropped { 0 };
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_written;
+    bool m_stopping = false;
+    std::thread m_writer;
+};
+
+// Fixed pool of worker threads sharing one task queue
+class ThreadPool {
+public:
+    // Receives the message of each exception a task ends with
+    using ExceptionHandler = std::function<void(const std::string& what)>;
+
+    ThreadPool(std::size_t threads, ExceptionHandler onException)
+        : m_onException(std::move(onException))
+    {
+        for (std::size_t i = 0; i < threads; ++i) {
+            m_workers.emplace_back([this] { run(); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t size() const { return m_workers.size(); }
+
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_wake.notify_one();
+    }
+
+    void waitForIdle()
+    {
+        std::unique_lock lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_tasks.empty() && m_running == 0; });
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            std::function<void()> task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_running;
+            lock.unlock();
+            // A throwing plugin task must not take the pool down
+            try {
+                task();
+            } catch (const std::exception& exception) {
+                m_onException(exception.what());
+            } catch (...) {
+                m_onException("unknown exception");
+            }
+            lock.lock();
+            if (--m_running == 0 && m_tasks.empty()) {
+                m_idle.notify_all();
+            }
+        }
+    }
+
+    ExceptionHandler m_onException;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::deque<std::function<void()>> m_tasks;
+    std::size_t m_running = 0;
+    bool m_stopping = false;
+    std::vector<std::thread> m_workers;
+};
+
+int lowestSetBit(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    for (; !(word & 1); word >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// Squawk codes that cannot be allocated: allocated from a range, held by an
+// aircraft, or cooling down after release. Blocked codes are kept as 64-bit
+// words, so the next free code of a range takes at most 64 word tests.
+class SquawkPool {
+public:
+    static constexpr std::size_t WordCount = SquawkCodeCount / 64;
+
+    // Set the code an aircraft squawks or was assigned; nullopt drops it. Codes
+    // gaining a second holder or going back to one are added to duplicates.
+    void hold(const std::string& callsign, std::optional<int> code,
+        std::vector<Squawk::DuplicateSquawkEvent>& duplicates)
+    {
+        const auto held = m_heldBy.find(callsign);
+        if (held != m_heldBy.end()) {
+            if (code == held->second) {
+                return;
+            }
+            const int previous = held->second;
+            const auto previousHolders = m_holders.equal_range(previous);
+            for (auto it = previousHolders.first; it != previousHolders.second; ++it) {
+                if (it->second == callsign) {
+                    m_holders.erase(it);
+                    break;
+                }
+            }
+            m_heldBy.erase(held);
+            update(previous);
+            if (m_holders.count(previous) == 1) {
+                m_duplicates.erase(previous);
+                duplicates.push_back({ formatSquawk(previous), holders(previous), false });
+            }
+        }
+        if (code) {
+            m_heldBy.emplace(callsign, *code);
+            m_holders.emplace(*code, callsign);
+            update(*code);
+            if (m_holders.count(*code) == 2) {
+                m_duplicates.insert(*code);
+                duplicates.push_back({ formatSquawk(*code), holders(*code), true });
+            }
+        }
+    }
+
+    std::vector<std::string> holders(int code) const
+    {
+        std::vector<std::string> callsigns;
+        const auto range = m_holders.equal_range(code);
+        for (auto it = range.first; it != range.second; ++it) {
+            callsigns.push_back(it->second);
+        }
+        return callsigns;
+    }
+
+    // Codes held by more than one aircraft, lowest first
+    const std::set<int>& duplicates() const { return m_duplicates; }
+
+    // Drop the holders absent from a snapshot's callsigns
+    template <typename Contains>
+    void dropHoldersExcept(
+        Contains contains, std::vector<Squawk::DuplicateSquawkEvent>& duplicates)
+    {
+        std::vector<std::string> gone;
+        for (const auto& [callsign, code] : m_heldBy) {
+            if (!contains(callsign)) {
+                gone.push_back(callsign);
+            }
+        }
+        for (const std::string& callsign : gone) {
+            hold(callsign, std::nullopt, duplicates);
+        }
+    }
+
+    // Next free code of [first, last]; a callsign already allocated one there gets it again
+    std::optional<int> allocate(int first, int last, const std::string& callsign,
+        std::chrono::nanoseconds now, std::chrono::nanoseconds cooldown)
+    {
+        expire(now, cooldown);
+        if (!callsign.empty()) {
+            const auto allocated = m_allocationOf.find(callsign);
+            if (allocated != m_allocationOf.end() && allocated->second >= first
+                && allocated->second <= last) {
+                return allocated->second;
+            }
+        }
+        for (int word = first / 64; word <= last / 64; ++word) {
+            std::uint64_t free = ~m_blocked[static_cast<std::size_t>(word)];
+            if (word == first / 64) {
+                free &= ~std::uint64_t(0) << (first % 64);
+            }
+            if (word == last / 64 && last % 64 != 63) {
+                free &= (std::uint64_t(1) << (last % 64 + 1)) - 1;
+            }
+            if (free) {
+                const int code = word * 64 + lowestSetBit(free);
+                m_allocated.set(static_cast<std::size_t>(code));
+                if (!callsign.empty()) {
+                    release(m_allocationOf[callsign], now);
+                    m_allocationOf[callsign] = code;
+                    m_allocatedTo[code] = callsign;
+                }
+                update(code);
+                return code;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void release(int code, std::chrono::nanoseconds now)
+    {
+        if (!m_allocated.test(static_cast<std::size_t>(code))) {
+            return;
+        }
+        m_allocated.reset(static_cast<std::size_t>(code));
+        const auto owner = m_allocatedTo.find(code);
+        if (owner != m_allocatedTo.end()) {
+            m_allocationOf.erase(owner->second);
+            m_allocatedTo.erase(owner);
+        }
+        m_released[code] = now;
+        m_releaseOrder.emplace_back(now, code);
+        update(code);
+    }
+
+    // Release the code allocated to an aircraft, e.g. when it disconnects
+    void releaseAllocation(const std::string& callsign, std::chrono::nanoseconds now)
+    {
+        const auto allocated = m_allocationOf.find(callsign);
+        if (allocated != m_allocationOf.end()) {
+            release(allocated->second, now);
+        }
+    }
+
+    bool isBlocked(int code, std::chrono::nanoseconds now, std::chrono::nanoseconds cooldown)
+    {
+        expire(now, cooldown);
+        return m_blocked[static_cast<std::size_t>(code) / 64] >> (code % 64) & 1;
+    }
+
+private:
+    // Releases leave in the order they were made, so only the oldest are checked
+    void expire(std::chrono::nanoseconds now, std::chrono::nanoseconds cooldown)
+    {
+        while (!m_releaseOrder.empty() && now - m_releaseOrder.front().first >= cooldown) {
+            const auto [time, code] = m_releaseOrder.front();
+            m_releaseOrder.pop_front();
+            const auto released = m_released.find(code);
+            if (released != m_released.end() && released->second == time) {
+                m_released.erase(released);
+                update(code);
+            }
+        }
+    }
+
+    void update(int code)
+    {
+        const auto index = static_cast<std::size_t>(code);
+        const std::uint64_t bit = std::uint64_t(1) << (index % 64);
+        if (m_allocated.test(index) || m_holders.count(code) || m_released.count(code)) {
+            m_blocked[index / 64] |= bit;
+        } else {
+            m_blocked[index / 64] &= ~bit;
+        }
+    }
+
+    std::array<std::uint64_t, WordCount> m_blocked {};
+    std::bitset<SquawkCodeCount> m_allocated;
+    std::unordered_map<std::string, int> m_allocationOf;
+    std::unordered_map<int, std::string> m_allocatedTo;
+    std::unordered_map<std::string, int> m_heldBy;
+    std::multimap<int, std::string> m_holders;
+    std::set<int> m_duplicates;
+    // Recording time of each release still cooling down, and releases in order
+    std::unordered_map<int, std::chrono::nanoseconds> m_released;
+    std::deque<std::pair<std::chrono::nanoseconds, int>> m_releaseOrder;
+};
+
+// Bounded log of one entity store's changes, fed by diffing snapshots
+class ChangeLog {
+public:
+    static constexpr std::size_t Capacity = 4096;
+
+    template <typename T> void update(const std::vector<T>& values, std::string T::*key)
+    {
+        std::unordered_map<std::string, std::string> encoded;
+        encoded.reserve(values.size());
+        for (const T& value : values) {
+            std::string current = Recording::encode(value);
+            const auto previous = m_encoded.find(value.*key);
+            if (previous == m_encoded.end()) {
+                record(value.*key, Change::Inserted);
+            } else if (previous->second != current) {
+                record(value.*key, Change::Updated);
+            }
+            encoded.emplace(value.*key, std::move(current));
+        }
+        for (const auto& [previousKey, previous] : m_encoded) {
+            if (!encoded.count(previousKey)) {
+                record(previousKey, Change::Removed);
+            }
+        }
+        m_encoded = std::move(encoded);
+    }
+
+    std::uint64_t sequence() const { return m_sequence; }
+
+    ChangeSet since(std::uint64_t sequence) const
+    {
+        ChangeSet changes;
+        changes.sequence = m_sequence;
+        if (sequence < m_discarded) {
+            changes.truncated = true;
+            return changes;
+        }
+
+        // First and last change of each key, in order of first change
+        std::vector<std::string> keys;
+        std::unordered_map<std::string, std::pair<Change, Change>> net;
+        const auto first = std::upper_bound(m_entries.begin(), m_entries.end(), sequence,
+            [](std::uint64_t value, const Entry& entry) { return value < entry.sequence; });
+        for (auto it = first; it != m_entries.end(); ++it) {
+            const auto [found, inserted] = net.try_emplace(it->key, it->change, it->change);
+            if (inserted) {
+                keys.push_back(it->key);
+            } else {
+                found->second.second = it->change;
+            }
+        }
+        for (std::string& key : keys) {
+            const auto [firstChange, lastChange] = net[key];
+            if (lastChange == Change::Removed) {
+                if (firstChange != Change::Inserted) {
+                    changes.removed.push_back(std::move(key));
+                }
+            } else if (firstChange == Change::Inserted) {
+                changes.inserted.push_back(std::move(key));
+            } else {
+                changes.updated.push_back(std::move(key));
+            }
+        }
+        return changes;
+    }
+
+private:
+    enum class Change { Inserted, Updated, Removed };
+
+    struct Entry {
+        std::uint64_t sequence;
+        std::string key;
+        Change change;
+    };
+
+    void record(const std::string& key, Change change)
+    {
+        m_entries.push_back({ ++m_sequence, key, change });
+        if (m_entries.size() > Capacity) {
+            m_discarded = m_entries.front().sequence;
+            m_entries.pop_front();
+        }
+    }
+
+    std::deque<Entry> m_entries;
+    std::uint64_t m_sequence = 0;
+    // Sequence number of the newest discarded entry
+    std::uint64_t m_discarded = 0;
+    std::unordered_map<std::string, std::string> m_encoded;
+};
+
+// Storage of one component type, indexed by entity record. Chunks never move,
+// so components stay at the same address for the life of their entity.
+class ComponentColumn {
+public:
+    static constexpr std::size_t ChunkSize = 64;
+
+    explicit ComponentColumn(const Component::ComponentType& type)
+        : m_type(type)
+        , m_stride((type.size + type.alignment - 1) / type.alignment * type.alignment)
+    {
+    }
+
+    ComponentColumn(const ComponentColumn&) = delete;
+    ComponentColumn& operator=(const ComponentColumn&) = delete;
+
+    ~ComponentColumn()
+    {
+        for (std::uint32_t index = 0; index < m_constructed.size(); ++index) {
+            destroy(index);
+        }
+    }
+
+    void* get(std::uint32_t index)
+    {
+        if (index >= m_constructed.size()) {
+            m_constructed.resize(index + 1, false);
+        }
+        void* storage = slot(index);
+        if (!m_constructed[index]) {
+            m_type.construct(storage);
+            m_constructed[index] = true;
+        }
+        return storage;
+    }
+
+    void* find(std::uint32_t index)
+    {
+        return index < m_constructed.size() && m_constructed[index] ? slot(index) : nullptr;
+    }
+
+    void destroy(std::uint32_t index)
+    {
+        if (index < m_constructed.size() && m_constructed[index]) {
+            m_constructed[index] = false;
+            m_type.destroy(slot(index));
+        }
+    }
+
+private:
+    struct ChunkDeleter {
+        std::size_t alignment;
+        void operator()(std::byte* chunk) const
+        {
+            ::operator delete(chunk, std::align_val_t(alignment));
+        }
+    };
+
+    void* slot(std::uint32_t index)
+    {
+        const std::size_t chunk = index / ChunkSize;
+        while (m_chunks.size() <= chunk) {
+            auto* memory = static_cast<std::byte*>(
+                ::operator new(m_stride * ChunkSize, std::align_val_t(m_type.alignment)));
+            m_chunks.emplace_back(memory, ChunkDeleter { m_type.alignment });
+        }
+        return m_chunks[chunk].get() + index % ChunkSize * m_stride;
+    }
+
+    Component::ComponentType m_type;
+    std::size_t m_stride;
+    std::vector<std::unique_ptr<std::byte, ChunkDeleter>> m_chunks;
+    std::vector<bool> m_constructed;
+};
+
+// Entity records of one kind and the plugin components attached to them
+class EntityTable {
+public:
+    explicit EntityTable(Component::EntityKind kind)
+        : m_kind(kind)
+    {
+    }
+
+    ComponentColumn& addColumn(const Component::ComponentType& type)
+    {
+        return *m_columns.emplace_back(std::make_unique<ComponentColumn>(type));
+    }
+
+    Component::EntityHandle find(const std::string& callsign) const
+    {
+        const auto it = m_index.find(callsign);
+        return it != m_index.end() ? handle(it->second) : Component::EntityHandle {};
+    }
+
+    // A removal still pending is applied first, so a reconnected entity starts
+    // with fresh components
+    void insert(const std::string& callsign)
+    {
+        const auto it = m_index.find(callsign);
+        if (it != m_index.end()) {
+            if (!m_records[it->second].removing) {
+                return;
+            }
+            remove(it->second);
+        }
+        std::uint32_t index;
+        if (!m_free.empty()) {
+            index = m_free.back();
+            m_free.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(m_records.size());
+            m_records.emplace_back();
+        }
+        Record& record = m_records[index];
+        record.callsign = callsign;
+        record.alive = true;
+        record.removing = false;
+        if (++record.generation == 0) {
+            record.generation = 1;
+        }
+        m_index.emplace(callsign, index);
+    }
+
+    // Components stay available until applyRemovals, so handlers of the
+    // removal event, batched ones included, can still read them
+    void scheduleRemoval(const std::string& callsign) { mark(callsign, m_removals); }
+
+    // Removals seen in a snapshot wait one more tick: the snapshot is recorded
+    // just before the event removing the entity, which has not been handled yet
+    void applyRemovals()
+    {
+        for (const std::uint32_t index : m_removals) {
+            if (m_records[index].alive && m_records[index].removing) {
+                remove(index);
+            }
+        }
+        m_removals.swap(m_snapshotRemovals);
+        m_snapshotRemovals.clear();
+    }
+
+    template <typename T> void sync(const std::vector<T>& values, std::string T::*key)
+    {
+        std::unordered_set<std::string_view> present;
+        present.reserve(values.size());
+        for (const T& value : values) {
+            insert(value.*key);
+            present.insert(value.*key);
+        }
+        for (const Record& record : m_records) {
+            if (record.alive && !present.count(record.callsign)) {
+                mark(record.callsign, m_snapshotRemovals);
+            }
+        }
+    }
+
+    void* component(ComponentColumn& column, Component::EntityHandle entity)
+    {
+        if (entity.kind != m_kind || entity.index >= m_records.size()) {
+            return nullptr;
+        }
+        const Record& record = m_records[entity.index];
+        return record.alive && record.generation == entity.generation ? column.get(entity.index)
+                                                                      : nullptr;
+    }
+
+    void forEach(ComponentColumn& column,
+        const std::function<void(const std::string&, void*)>& function)
+    {
+        for (std::uint32_t index = 0; index < m_records.size(); ++index) {
+            if (!m_records[index].alive) {
+                continue;
+            }
+            if (void* component = column.find(index)) {
+                function(m_records[index].callsign, component);
+            }
+        }
+    }
+
+private:
+    struct Record {
+        std::string callsign;
+        std::uint32_t generation = 0;
+        bool alive = false;
+        bool removing = false;
+    };
+
+    Component::EntityHandle handle(std::uint32_t index) const
+    {
+        return { m_kind, index, m_records[index].generation };
+    }
+
+    void mark(const std::string& callsign, std::vector<std::uint32_t>& removals)
+    {
+        const auto it = m_index.find(callsign);
+        if (it != m_index.end() && !m_records[it->second].removing) {
+            m_records[it->second].removing = true;
+            removals.push_back(it->second);
+        }
+    }
+
+    void remove(std::uint32_t index)
+    {
+        for (const auto& column : m_columns) {
+            column->destroy(index);
+        }
+        Record& record = m_records[index];
+        m_index.erase(record.callsign);
+        record.alive = false;
+        record.removing = false;
+        m_free.push_back(index);
+    }
+
+    Component::EntityKind m_kind;
+    std::vector<Record> m_records;
+    std::unordered_map<std::string, std::uint32_t> m_index;
+    std::vector<std::uint32_t> m_free;
+    std::vector<std::uint32_t> m_removals;
+    std::vector<std::uint32_t> m_snapshotRemovals;
+    std::vector<std::unique_ptr<ComponentColumn>> m_columns;
+};
+
+// Cheap timestamps for timing CoreAPI calls: the TSC on x86, steady_clock
+// nanoseconds elsewhere
+struct CycleClock {
+    static std::uint64_t now()
+    {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(Clock::now().time_since_epoch().count());
+#endif
+    }
+};
+
+// Heap use attributed to a plugin, fed by recordAllocation and recordDeallocation
+struct AllocationCounters {
+    std::atomic<std::uint64_t> allocations { 0 };
+    std::atomic<std::uint64_t> deallocations { 0 };
+    std::atomic<std::uint64_t> allocatedBytes { 0 };
+    std::atomic<std::int64_t> liveBytes { 0 };
+    std::atomic<std::int64_t> peakLiveBytes { 0 };
+
+    void allocate(std::size_t bytes)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        const std::int64_t live = liveBytes.fetch_add(static_cast<std::int64_t>(bytes),
+                                      std::memory_order_relaxed)
+            + static_cast<std::int64_t>(bytes);
+        std::int64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak
+            && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void deallocate(std::size_t bytes)
+    {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        liveBytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        allocations.store(0, std::memory_order_relaxed);
+        deallocations.store(0, std::memory_order_relaxed);
+        allocatedBytes.store(0, std::memory_order_relaxed);
+        liveBytes.store(0, std::memory_order_relaxed);
+        peakLiveBytes.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Set once the replacement allocation functions report anything
+std::atomic<bool> allocationsTracked { false };
+
+// Event raised by the host itself, delivered through the same path as recorded ones
+template <typename T> class HostEvent : public Recording::RecordedEvent {
+public:
+    using Handler = void (BasePlugin::*)(const T*);
+
+    HostEvent(EventType type, T event, Handler handler)
+        : m_type(type)
+        , m_event(std::move(event))
+        , m_handler(handler)
+    {
+    }
+
+    EventType type() const override { return m_type; }
+    void* data() override { return &m_event; }
+    const void* data() const override { return &m_event; }
+    void dispatch(BasePlugin& plugin) const override { (plugin.*m_handler)(&m_event); }
+
+private:
+    EventType m_type;
+    T m_event;
+    Handler m_handler;
+};
+
+// SquawkAssignedEvent points into strings, which the event owns
+class HostSquawkAssigned : public Recording::RecordedEvent {
+public:
+    HostSquawkAssigned(std::string callsign, std::string squawk, std::string providerName)
+        : m_callsign(std::move(callsign))
+        , m_squawk(std::move(squawk))
+        , m_providerName(std::move(providerName))
+        , m_event { m_callsign.c_str(), m_squawk.c_str(), m_providerName.c_str() }
+    {
+    }
+
+    HostSquawkAssigned(const HostSquawkAssigned&) = delete;
+    HostSquawkAssigned& operator=(const HostSquawkAssigned&) = delete;
+
+    EventType type() const override { return EventType::SquawkAssigned; }
+    void* data() override { return &m_event; }
+    const void* data() const override { return &m_event; }
+    void dispatch(BasePlugin& plugin) const override { plugin.OnSquawkAssigned(&m_event); }
+
+private:
+    std::string m_callsign;
+    std::string m_squawk;
+    std::string m_providerName;
+    Squawk::SquawkAssignedEvent m_event;
+};
+
+} // namespace
+
+// State shared by the API objects. Held by shared_ptr so registration tokens
+// outliving the host can detect that it is gone.
+struct State {
+    BasePlugin* plugin = nullptr;
+    ReplayCounters counters;
+    // Main-thread work; pool tasks post here too
+    std::mutex pendingMutex;
+    std::vector<std::function<void()>> pending;
+    // Events raised by the host, delivered after the event being dispatched
+    std::vector<std::unique_ptr<Recording::RecordedEvent>> hostEvents;
+    // Scheduler pool, owned by ReplaySchedulerAPI; host work runs there too
+    ThreadPool* workers = nullptr;
+
+    // Scheduler timers, in recording time
+    std::mutex timerMutex;
+    std::chrono::milliseconds tickInterval { 50 };
+    std::chrono::nanoseconds now { 0 };
+    std::uint64_t nextTimerId = 1;
+    std::map<std::uint64_t, Timer> timers;
+
+    // One-shot event waits, by event type
+    std::mutex waiterMutex;
+    std::uint64_t nextWaiterId = 1;
+    std::array<std::map<std::uint64_t, std::shared_ptr<EventWaiter>>,
+        static_cast<std::size_t>(EventType::Count)>
+        waiters;
+    // Types ever waited for; an isolated plugin may register its next wait
+    // after the host thread has read the event
+    EventMask waited = EventMask::None();
+
+    IsolatedDispatcher* dispatcher = nullptr;
+
+    // Guards the snapshot, its indexes and change logs, and the tag and squawk
+    // state: plugin calls from pool threads read under a shared lock, while
+    // setSnapshot and the CoreAPI writers take it exclusively. Squawk
+    // generation and dropdown item sources run without it.
+    mutable std::shared_mutex dataMutex;
+    Recording::Snapshot snapshot;
+    std::unordered_map<std::string, std::size_t> aircraftIndex;
+    std::unordered_map<std::string, std::size_t> flightplanIndex;
+    std::unordered_map<std::string, std::size_t> controllerIndex;
+    std::unordered_map<std::string, std::size_t> controllerDataIndex;
+    std::unordered_map<std::string, std::size_t> airportIndex;
+    ChangeLog aircraftChanges;
+    ChangeLog flightplanChanges;
+    ChangeLog controllerChanges;
+    ChangeLog controllerDataChanges;
+    ChangeLog airportChanges;
+
+    // Plugin components, by entity kind; ComponentId n is components[n - 1]
+    std::array<EntityTable, 3> entities { EntityTable(Component::EntityKind::Aircraft),
+        EntityTable(Component::EntityKind::Flightplan),
+        EntityTable(Component::EntityKind::Controller) };
+    std::vector<std::pair<EntityTable*, ComponentColumn*>> components;
+
+    EntityTable& entityTable(Component::EntityKind kind)
+    {
+        return entities[static_cast<std::size_t>(kind)];
+    }
+
+    // Metrics; handler times in nanoseconds, CoreAPI times in CycleClock ticks
+    std::array<LatencyHistogram, static_cast<std::size_t>(EventType::Count)> handlerLatency;
+    LatencyHistogram anyHandlerLatency;
+    LatencyHistogram batchLatency;
+    std::array<LatencyHistogram, static_cast<std::size_t>(Metrics::Api::Count)> apiLatency;
+    AllocationCounters allocations;
+    // Recording time of the last reset, guarded by timerMutex
+    std::chrono::nanoseconds metricsStart { 0 };
+    std::chrono::nanoseconds metricsInterval { 0 };
+    std::chrono::nanoseconds lastMetricsDump { 0 };
+    std::atomic<std::uint64_t> taskExceptions { 0 };
+    // Calibrates CycleClock against steady_clock
+    const std::uint64_t cycleStart = CycleClock::now();
+    const Clock::time_point clockStart = Clock::now();
+
+    // Tag
+    std::uint64_t nextTagId = 1;
+    std::unordered_map<std::uint64_t, std::string> dataKeys;
+    std::map<std::pair<std::string, std::string>, Tag::TagValueUpdate> tagValues;
+    std::unordered_map<std::string, std::shared_ptr<Tag::TagValueProvider>> tagProviders;
+    std::unordered_map<std::string, Tag::DropdownDefinition> dropdowns;
+    // By action ID, then ScrollArea component ID
+    std::map<std::string, std::map<std::string, VirtualScrollArea>> scrollAreas;
+
+    // Chat
+    // Guards the commands, subscriptions, history and the client message queue,
+    // which an isolated plugin's worker thread uses while the replay thread
+    // receives messages
+    std::mutex messageMutex;
+    std::uint64_t nextCommandId = 1;
+    std::map<std::string, RegisteredCommand> commands;
+    std::uint64_t nextSubscriptionId = 1;
+    std::vector<MessageSubscription> subscriptions;
+    ChatHistory history;
+    std::uint64_t nextSequence = 1;
+    Chat::ClientMessageQueueOptions queueOptions;
+    Chat::ClientMessageQueueStats queueStats;
+    std::deque<QueuedClientMessage> clientQueue;
+
+    // Squawk
+    std::vector<std::shared_ptr<Squawk::SquawkProviderInterface>> squawkProviders;
+    std::string activeProvider;
+    std::map<std::string, Squawk::SquawkRangeReservation> ranges;
+    SquawkPool squawkPool;
+    std::chrono::seconds releaseCooldown { 120 };
+    std::chrono::milliseconds providerDeadline { 1000 };
+
+    // Logger
+    std::atomic<Logger::LogLevel> logLevel { Logger::LogLevel::Warning };
+    // Guards formats, binaryLog and droppedLogMessages
+    std::mutex logMutex;
+    LogFormats formats;
+    BinaryLogWriter binaryLog;
+    std::uint64_t droppedLogMessages = 0;
+    // Text lines of the plugin and the host, written to stderr in order
+    mutable LogQueue logLines;
+
+    template <typename T>
+    static void index(const std::vector<T>& values,
+        std::unordered_map<std::string, std::size_t>& map, std::string T::*key)
+    {
+        map.clear();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            map[values[i].*key] = i;
+        }
+    }
+
+    // Lock-taking readers of the snapshot, for the query APIs
+    template <typename T>
+    std::optional<T> find(const std::vector<T>& values,
+        const std::unordered_map<std::string, std::size_t>& map, const std::string& key)
+    {
+        ++counters.queries;
+        std::shared_lock lock(dataMutex);
+        const auto it = map.find(key);
+        return it != map.end() ? std::optional<T>(values[it->second]) : std::nullopt;
+    }
+
+    // Copy-assigns into the elements out already holds, reusing their storage
+    template <typename T, typename Container>
+    void copyAll(const std::vector<T>& values, Container& out)
+    {
+        ++counters.queries;
+        std::shared_lock lock(dataMutex);
+        out.assign(values.begin(), values.end());
+    }
+
+    template <typename T> T copy(const T& value)
+    {
+        ++counters.queries;
+        std::shared_lock lock(dataMutex);
+        return value;
+    }
+
+    std::uint64_t sequence(const ChangeLog& changes)
+    {
+        ++counters.queries;
+        std::shared_lock lock(dataMutex);
+        return changes.sequence();
+    }
+
+    ChangeSet changesSince(const ChangeLog& changes, std::uint64_t sequence)
+    {
+        ++counters.queries;
+        std::shared_lock lock(dataMutex);
+        return changes.since(sequence);
+    }
+
+    std::chrono::nanoseconds currentTime()
+    {
+        std::lock_guard lock(timerMutex);
+        return now;
+    }
+
+    // Host diagnostics, echoed to stderr next to the plugin's messages
+    void logHost(Logger::LogLevel level, const std::string& message) const
+    {
+        if (level <= logLevel) {
+            logLines.push("[host] " + message);
+        }
+    }
+
+    // Expires cooled down releases, so the caller holds dataMutex exclusively
+    bool isCodeInUse(int code)
+    {
+        return squawkPool.isBlocked(code, currentTime(), releaseCooldown);
+    }
+
+    void postEvent(std::unique_ptr<Recording::RecordedEvent> event)
+    {
+        std::lock_guard lock(pendingMutex);
+        hostEvents.push_back(std::move(event));
+    }
+
+    void postDuplicates(std::vector<Squawk::DuplicateSquawkEvent>& duplicates)
+    {
+        if (duplicates.empty()) {
+            return;
+        }
+        std::lock_guard lock(pendingMutex);
+        for (Squawk::DuplicateSquawkEvent& duplicate : duplicates) {
+            hostEvents.push_back(std::make_unique<HostEvent<Squawk::DuplicateSquawkEvent>>(
+                EventType::DuplicateSquawk, std::move(duplicate),
+                &BasePlugin::OnDuplicateSquawk));
+        }
+        duplicates.clear();
+    }
+};
+
+namespace {
+
+// Plugin whose code runs on this thread, receiving its allocations
+thread_local State* allocationOwner = nullptr;
+
+// Attributes allocations on this thread to a plugin while alive
+class AllocationScope {
+public:
+    explicit AllocationScope(State* state)
+        : m_previous(allocationOwner)
+    {
+        allocationOwner = state;
+    }
+    ~AllocationScope() { allocationOwner = m_previous; }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    State* m_previous;
+};
+
+// Depth of CoreAPI calls on this thread
+thread_local unsigned apiCallDepth = 0;
+
+// Times a CoreAPI call; calls the host makes to itself while serving it are not timed again
+class ApiCallTimer {
+public:
+    ApiCallTimer(State& state, Metrics::Api api)
+        : m_histogram(
+              apiCallDepth++ == 0 ? &state.apiLatency[static_cast<std::size_t>(api)] : nullptr)
+        , m_start(m_histogram ? CycleClock::now() : 0)
+    {
+    }
+
+    ~ApiCallTimer()
+    {
+        if (m_histogram) {
+            m_histogram->record(CycleClock::now() - m_start);
+        }
+        --apiCallDepth;
+    }
+
+    ApiCallTimer(const ApiCallTimer&) = delete;
+    ApiCallTimer& operator=(const ApiCallTimer&) = delete;
+
+private:
+    LatencyHistogram* m_histogram;
+    std::uint64_t m_start;
+};
+
+Metrics::PluginMetrics collectMetrics(State& state)
+{
+    Metrics::PluginMetrics metrics;
+    {
+        std::lock_guard lock(state.timerMutex);
+        metrics.window = state.now - state.metricsStart;
+    }
+    const double seconds = metrics.window.count() / 1e9;
+
+    metrics.handlers = state.anyHandlerLatency.summary();
+    for (std::size_t type = 0; type < state.handlerLatency.size(); ++type) {
+        const LatencyHistogram& histogram = state.handlerLatency[type];
+        if (histogram.count() > 0) {
+            const double rate = seconds > 0 ? histogram.count() / seconds : 0.0;
+            metrics.events.push_back({ static_cast<EventType>(type), histogram.summary(), rate });
+        }
+    }
+    metrics.batches = state.batchLatency.summary();
+
+    const std::uint64_t cycles = CycleClock::now() - state.cycleStart;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - state.clockStart);
+    const double nanosecondsPerCycle
+        = cycles > 0 ? static_cast<double>(elapsed.count()) / static_cast<double>(cycles) : 1.0;
+    for (std::size_t api = 0; api < state.apiLatency.size(); ++api) {
+        const LatencyHistogram& histogram = state.apiLatency[api];
+        if (histogram.count() > 0) {
+            metrics.apiCalls.push_back(
+                { static_cast<Metrics::Api>(api), histogram.summary(nanosecondsPerCycle) });
+        }
+    }
+
+    metrics.taskExceptions = state.taskExceptions.load(std::memory_order_relaxed);
+
+    const AllocationCounters& counters = state.allocations;
+    metrics.allocations.tracked = allocationsTracked.load(std::memory_order_relaxed);
+    metrics.allocations.allocations = counters.allocations.load(std::memory_order_relaxed);
+    metrics.allocations.deallocations = counters.deallocations.load(std::memory_order_relaxed);
+    metrics.allocations.allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+    metrics.allocations.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    metrics.allocations.peakLiveBytes = counters.peakLiveBytes.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+void resetMetrics(State& state)
+{
+    for (LatencyHistogram& histogram : state.handlerLatency) {
+        histogram.reset();
+    }
+    state.anyHandlerLatency.reset();
+    state.batchLatency.reset();
+    for (LatencyHistogram& histogram : state.apiLatency) {
+        histogram.reset();
+    }
+    state.allocations.reset();
+    state.taskExceptions = 0;
+    std::lock_guard lock(state.timerMutex);
+    state.metricsStart = state.now;
+}
+
+// Send the queued client messages whose merge window closed by a recording time
+void sendClientMessages(State& state, std::chrono::nanoseconds time)
+{
+    std::lock_guard lock(state.messageMutex);
+    auto& queue = state.clientQueue;
+    while (!queue.empty() && time - queue.front().queued >= state.queueOptions.mergeWindow) {
+        queue.pop_front();
+        ++state.queueStats.sent;
+        ++state.counters.messagesSent;
+    }
+}
+
+// Periodic dump written to stderr, one line per figure
+std::string formatMetrics(const Metrics::PluginMetrics& metrics)
+{
+    const auto us = [](std::chrono::nanoseconds duration) { return duration.count() / 1000.0; };
+    const auto line = [&](std::ostringstream& out, const char* name,
+                          const Metrics::LatencySummary& latency, double rate) {
+        out << "[metrics]   " << std::left << std::setw(32) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(9) << rate << "/s" << std::setprecision(2)
+            << "  p50 " << us(latency.p50) << " us  p99 " << us(latency.p99) << " us  max "
+            << us(latency.max) << " us\n";
+    };
+
+    std::ostringstream out;
+    const double seconds = metrics.window.count() / 1e9;
+    out << std::fixed << std::setprecision(1) << "[metrics] " << seconds << " s, "
+        << metrics.handlers.count << " handler calls";
+    if (metrics.allocations.tracked) {
+        out << ", heap " << metrics.allocations.liveBytes / 1024.0 << " KiB live ("
+            << metrics.allocations.peakLiveBytes / 1024.0 << " KiB peak)";
+    }
+    if (metrics.taskExceptions > 0) {
+        out << ", " << metrics.taskExceptions << " task exceptions";
+    }
+    out << "\n";
+    for (const Metrics::HandlerMetrics& handler : metrics.events) {
+        line(out, GetEventTypeName(handler.type), handler.latency, handler.rate);
+    }
+    if (metrics.batches.count > 0) {
+        line(out, "EventBatch", metrics.batches, seconds > 0 ? metrics.batches.count / seconds : 0);
+    }
+    for (const Metrics::ApiMetrics& api : metrics.apiCalls) {
+        line(out, (std::string("CoreAPI ") + Metrics::GetApiName(api.api)).c_str(), api.latency,
+            seconds > 0 ? api.latency.count / seconds : 0);
+    }
+    return out.str();
+}
+
+class ReplayPackageAPI : public Package::PackageAPI {
+public:
+    explicit ReplayPackageAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::filesystem::path getPackagePath() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Package);
+        return {};
+    }
+
+private:
+    State& m_state;
+};
+
+class ReplayAircraftAPI : public Aircraft::AircraftAPI {
+public:
+    explicit ReplayAircraftAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::vector<Aircraft::Aircraft> getAll() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        return m_state.copy(m_state.snapshot.aircraft);
+    }
+
+    void getAll(std::vector<Aircraft::Aircraft>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        m_state.copyAll(m_state.snapshot.aircraft, out);
+    }
+
+    void getAll(std::pmr::vector<Aircraft::Aircraft>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        m_state.copyAll(m_state.snapshot.aircraft, out);
+    }
+
+    std::optional<Aircraft::Aircraft> getByCallsign(const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        return m_state.find(m_state.snapshot.aircraft, m_state.aircraftIndex, callsign);
+    }
+
+    std::optional<double> getDistanceFromOrigin(const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        return distance(callsign, &Flightplan::Flightplan::originWaypoint);
+    }
+
+    std::optional<double> getDistanceToDestination(const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        return distance(callsign, &Flightplan::Flightplan::destinationWaypoint);
+    }
+
+    std::uint64_t getSequence() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        return m_state.sequence(m_state.aircraftChanges);
+    }
+
+    ChangeSet changesSince(std::uint64_t sequence) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Aircraft);
+        return m_state.changesSince(m_state.aircraftChanges, sequence);
+    }
+
+private:
+    std::optional<double> distance(const std::string& callsign,
+        std::optional<Flightplan::Waypoint> Flightplan::Flightplan::*waypoint)
+    {
+        ++m_state.counters.queries;
+        std::shared_lock lock(m_state.dataMutex);
+        const auto aircraft = m_state.aircraftIndex.find(callsign);
+        const auto flightplan = m_state.flightplanIndex.find(callsign);
+        if (aircraft == m_state.aircraftIndex.end()
+            || flightplan == m_state.flightplanIndex.end()) {
+            return std::nullopt;
+        }
+        const auto& position = m_state.snapshot.aircraft[aircraft->second].position;
+        const auto& target = m_state.snapshot.flightplans[flightplan->second].*waypoint;
+        if (!target) {
+            return std::nullopt;
+        }
+        return distanceNm(position.latitude, position.longitude, target->position.latitude,
+            target->position.longitude);
+    }
+
+    State& m_state;
+};
+
+class ReplayFlightplanAPI : public Flightplan::FlightplanAPI {
+public:
+    explicit ReplayFlightplanAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::vector<Flightplan::Flightplan> getAll() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Flightplan);
+        return m_state.copy(m_state.snapshot.flightplans);
+    }
+
+    void getAll(std::vector<Flightplan::Flightplan>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Flightplan);
+        m_state.copyAll(m_state.snapshot.flightplans, out);
+    }
+
+    void getAll(std::pmr::vector<Flightplan::Flightplan>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Flightplan);
+        m_state.copyAll(m_state.snapshot.flightplans, out);
+    }
+
+    std::optional<Flightplan::Flightplan> getByCallsign(const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Flightplan);
+        return m_state.find(m_state.snapshot.flightplans, m_state.flightplanIndex, callsign);
+    }
+
+    std::uint64_t getSequence() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Flightplan);
+        return m_state.sequence(m_state.flightplanChanges);
+    }
+
+    ChangeSet changesSince(std::uint64_t sequence) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Flightplan);
+        return m_state.changesSince(m_state.flightplanChanges, sequence);
+    }
+
+private:
+    State& m_state;
+};
+
+class ReplayControllerAPI : public Controller::ControllerAPI {
+public:
+    explicit ReplayControllerAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::vector<Controller::Controller> getAll() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Controller);
+        return m_state.copy(m_state.snapshot.controllers);
+    }
+
+    void getAll(std::vector<Controller::Controller>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Controller);
+        m_state.copyAll(m_state.snapshot.controllers, out);
+    }
+
+    void getAll(std::pmr::vector<Controller::Controller>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Controller);
+        m_state.copyAll(m_state.snapshot.controllers, out);
+    }
+
+    std::optional<Controller::Controller> getByCallsign(const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Controller);
+        return m_state.find(m_state.snapshot.controllers, m_state.controllerIndex, callsign);
+    }
+
+    std::uint64_t getSequence() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Controller);
+        return m_state.sequence(m_state.controllerChanges);
+    }
+
+    ChangeSet changesSince(std::uint64_t sequence) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Controller);
+        return m_state.changesSince(m_state.controllerChanges, sequence);
+    }
+
+private:
+    State& m_state;
+};
+
+class ReplayControllerDataAPI : public ControllerData::ControllerDataAPI {
+public:
+    explicit ReplayControllerDataAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::vector<ControllerData::ControllerDataModel> getAll() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::ControllerData);
+        return m_state.copy(m_state.snapshot.controllerData);
+    }
+
+    void getAll(std::vector<ControllerData::ControllerDataModel>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::ControllerData);
+        m_state.copyAll(m_state.snapshot.controllerData, out);
+    }
+
+    void getAll(std::pmr::vector<ControllerData::ControllerDataModel>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::ControllerData);
+        m_state.copyAll(m_state.snapshot.controllerData, out);
+    }
+
+    std::optional<ControllerData::ControllerDataModel> getByCallsign(
+        const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::ControllerData);
+        return m_state.find(m_state.snapshot.controllerData, m_state.controllerDataIndex, callsign);
+    }
+
+    bool setGroundStatus(const std::string&, const ControllerData::GroundStatus) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::ControllerData);
+        ++m_state.counters.writes;
+        return true;
+    }
+
+    std::uint64_t getSequence() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::ControllerData);
+        return m_state.sequence(m_state.controllerDataChanges);
+    }
+
+    ChangeSet changesSince(std::uint64_t sequence) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::ControllerData);
+        return m_state.changesSince(m_state.controllerDataChanges, sequence);
+    }
+
+private:
+    State& m_state;
+};
+
+class ReplayAirportAPI : public Airport::AirportAPI {
+public:
+    explicit ReplayAirportAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::vector<Airport::AirportConfig> getConfigurations() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return m_state.copy(m_state.snapshot.airports);
+    }
+
+    void getConfigurations(std::vector<Airport::AirportConfig>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        m_state.copyAll(m_state.snapshot.airports, out);
+    }
+
+    void getConfigurations(std::pmr::vector<Airport::AirportConfig>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        m_state.copyAll(m_state.snapshot.airports, out);
+    }
+
+    std::optional<Airport::AirportConfig> getConfigurationByIcao(const std::string& icao) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return m_state.find(m_state.snapshot.airports, m_state.airportIndex, icao);
+    }
+
+    bool isDepRunwayActive(const std::string& icao, const std::string& runway) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        const auto config = getConfigurationByIcao(icao);
+        return config
+            && std::find(config->depRunways.begin(), config->depRunways.end(), runway)
+            != config->depRunways.end();
+    }
+
+    bool isArrRunwayActive(const std::string& icao, const std::string& runway) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        const auto config = getConfigurationByIcao(icao);
+        return config
+            && std::find(config->arrRunways.begin(), config->arrRunways.end(), runway)
+            != config->arrRunways.end();
+    }
+
+    bool setRunwayStatus(const std::string&, const std::string&, const Airport::RunwayType) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return write();
+    }
+
+    bool setShowRunwayCenterlines(const std::string&, bool) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return write();
+    }
+
+    bool removeRunwayStatus(
+        const std::string&, const std::string&, const Airport::RunwayType) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return write();
+    }
+
+    std::tuple<std::vector<Airport::RunwayStatusChange>, std::vector<Airport::RunwayStatusChange>,
+        std::vector<Airport::RunwayStatusChange>, std::vector<Airport::RunwayStatusChange>>
+    batchUpdateRunways(const std::vector<Airport::RunwayStatusChange>& toAdd,
+        const std::vector<Airport::RunwayStatusChange>& toRemove) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        write();
+        return { toAdd, {}, toRemove, {} };
+    }
+
+    bool deleteAirport(const std::string&) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return write();
+    }
+
+    bool setAirportStatus(const std::string&, Airport::AirportStatus) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return write();
+    }
+
+    std::uint64_t getSequence() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return m_state.sequence(m_state.airportChanges);
+    }
+
+    ChangeSet changesSince(std::uint64_t sequence) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Airport);
+        return m_state.changesSince(m_state.airportChanges, sequence);
+    }
+
+private:
+    bool write()
+    {
+        ++m_state.counters.writes;
+        return true;
+    }
+
+    State& m_state;
+};
+
+class ReplaySquawkAPI : public Squawk::SquawkAPI {
+public:
+    ReplaySquawkAPI(State& state, std::weak_ptr<State> weak)
+        : m_state(state)
+        , m_weak(std::move(weak))
+    {
+    }
+
+    bool registerProvider(std::shared_ptr<Squawk::SquawkProviderInterface> provider) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        if (!provider) {
+            return false;
+        }
+        const std::string name = provider->GetProviderName();
+        std::unique_lock lock(m_state.dataMutex);
+        if (findProvider(name)) {
+            return false;
+        }
+        m_state.squawkProviders.push_back(std::move(provider));
+        return true;
+    }
+
+    std::unique_ptr<Squawk::RegistrationToken> registerProviderWithToken(
+        std::shared_ptr<Squawk::SquawkProviderInterface> provider) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        if (!registerProvider(provider)) {
+            return nullptr;
+        }
+        return std::make_unique<Token<Squawk::RegistrationToken>>(
+            [weak = m_weak, raw = provider.get()] {
+                if (auto state = weak.lock()) {
+                    std::unique_lock lock(state->dataMutex);
+                    auto& providers = state->squawkProviders;
+                    providers.erase(std::remove_if(providers.begin(), providers.end(),
+                                        [&](const auto& p) { return p.get() == raw; }),
+                        providers.end());
+                }
+            });
+    }
+
+    bool setActiveProvider(const char* providerName) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        std::unique_lock lock(m_state.dataMutex);
+        if (!providerName || !findProvider(providerName)) {
+            return false;
+        }
+        m_state.activeProvider = providerName;
+        return true;
+    }
+
+    std::vector<std::string> getAvailableProviders() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        std::vector<std::string> names;
+        providerNames(names);
+        return names;
+    }
+
+    void getAvailableProviders(std::vector<std::string>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        providerNames(out);
+    }
+
+    void getAvailableProviders(std::pmr::vector<std::pmr::string>& out) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        providerNames(out);
+    }
+
+    bool reserveRange(const Squawk::SquawkRangeReservation& reservation) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        const auto first = parseSquawk(reservation.firstCode);
+        const auto last = parseSquawk(reservation.lastCode);
+        std::unique_lock lock(m_state.dataMutex);
+        if (reservation.name.empty() || !first || !last || *first > *last
+            || m_state.ranges.count(reservation.name)) {
+            return false;
+        }
+        for (const auto& [name, range] : m_state.ranges) {
+            if (*first <= *parseSquawk(range.lastCode) && *parseSquawk(range.firstCode) <= *last) {
+                return false;
+            }
+        }
+        m_state.ranges[reservation.name] = reservation;
+        return true;
+    }
+
+    bool releaseRange(const std::string& name) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        std::unique_lock lock(m_state.dataMutex);
+        return m_state.ranges.erase(name) > 0;
+    }
+
+    std::optional<std::string> allocateCode(
+        const std::string& rangeName, const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        std::unique_lock lock(m_state.dataMutex);
+        const auto range = m_state.ranges.find(rangeName);
+        if (range == m_state.ranges.end()) {
+            return std::nullopt;
+        }
+        const auto code = m_state.squawkPool.allocate(*parseSquawk(range->second.firstCode),
+            *parseSquawk(range->second.lastCode), callsign, m_state.currentTime(),
+            m_state.releaseCooldown);
+        return code ? std::optional<std::string>(formatSquawk(*code)) : std::nullopt;
+    }
+
+    void releaseCode(const std::string& code) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        const auto value = parseSquawk(code);
+        std::unique_lock lock(m_state.dataMutex);
+        if (value) {
+            m_state.squawkPool.release(*value, m_state.currentTime());
+        }
+    }
+
+    bool isCodeInUse(const std::string& code) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        const auto value = parseSquawk(code);
+        if (!value) {
+            return false;
+        }
+        std::unique_lock lock(m_state.dataMutex);
+        return m_state.isCodeInUse(*value);
+    }
+
+    void setReleaseCooldown(std::chrono::seconds cooldown) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        std::unique_lock lock(m_state.dataMutex);
+        m_state.releaseCooldown = cooldown;
+    }
+
+    std::vector<std::string> getCallsignsBySquawk(const std::string& code) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        ++m_state.counters.queries;
+        const auto value = parseSquawk(code);
+        if (!value) {
+            return {};
+        }
+        std::shared_lock lock(m_state.dataMutex);
+        return m_state.squawkPool.holders(*value);
+    }
+
+    std::vector<std::string> getDuplicateSquawks() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        ++m_state.counters.queries;
+        std::vector<std::string> duplicates;
+        std::shared_lock lock(m_state.dataMutex);
+        for (const int code : m_state.squawkPool.duplicates()) {
+            duplicates.push_back(formatSquawk(code));
+        }
+        return duplicates;
+    }
+
+    void assignSquawks(const std::vector<std::string>& callsigns) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        auto job = std::make_shared<SquawkJob>();
+        std::shared_lock dataLock(m_state.dataMutex);
+        job->providers = providersByPriority();
+        job->deadline = m_state.providerDeadline;
+        for (const std::string& callsign : callsigns) {
+            const auto aircraft = m_state.aircraftIndex.find(callsign);
+            const auto flightplan = m_state.flightplanIndex.find(callsign);
+            if (aircraft != m_state.aircraftIndex.end()
+                && flightplan != m_state.flightplanIndex.end()) {
+                job->callsigns.push_back(callsign);
+                job->aircraft.push_back(m_state.snapshot.aircraft[aircraft->second]);
+                job->flightplans.push_back(m_state.snapshot.flightplans[flightplan->second]);
+            }
+        }
+        dataLock.unlock();
+        if (job->providers.empty() || job->callsigns.empty()) {
+            return;
+        }
+        m_state.workers->post([this, job] { generate(job); });
+    }
+
+    void setProviderDeadline(std::chrono::milliseconds deadline) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Squawk);
+        std::unique_lock lock(m_state.dataMutex);
+        m_state.providerDeadline = std::max(deadline, std::chrono::milliseconds(0));
+    }
+
+private:
+    // Assigns into the strings out already holds, reusing their buffers
+    template <typename Container> void providerNames(Container& out) const
+    {
+        std::shared_lock lock(m_state.dataMutex);
+        out.resize(m_state.squawkProviders.size());
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            const std::string name = m_state.squawkProviders[i]->GetProviderName();
+            out[i].assign(name.data(), name.size());
+        }
+    }
+
+    // Callers hold dataMutex
+    std::shared_ptr<Squawk::SquawkProviderInterface> findProvider(const std::string& name) const
+    {
+        for (const auto& provider : m_state.squawkProviders) {
+            if (provider->GetProviderName() == name) {
+                return provider;
+            }
+        }
+        return nullptr;
+    }
+
+    // The active provider, then the others by descending priority; callers hold dataMutex
+    std::vector<std::shared_ptr<Squawk::SquawkProviderInterface>> providersByPriority() const
+    {
+        auto providers = m_state.squawkProviders;
+        std::stable_sort(providers.begin(), providers.end(), [&](const auto& a, const auto& b) {
+            const bool aActive = a->GetProviderName() == m_state.activeProvider;
+            const bool bActive = b->GetProviderName() == m_state.activeProvider;
+            return aActive != bActive ? aActive : a->GetPriority() > b->GetPriority();
+        });
+        return providers;
+    }
+
+    // Asks each provider in turn for the codes still missing. A provider that
+    // misses the deadline or throws is skipped; its late answer is discarded.
+    void generate(const std::shared_ptr<SquawkJob>& job)
+    {
+        const std::size_t count = job->callsigns.size();
+        std::vector<std::string> codes(count);
+        std::vector<std::string> providerNames(count);
+        // Calls that missed the deadline, joined before returning
+        std::vector<std::future<std::vector<std::string>>> late;
+
+        for (const auto& provider : job->providers) {
+            std::vector<std::size_t> missing;
+            auto requests = std::make_shared<std::vector<Squawk::SquawkRequest>>();
+            for (std::size_t i = 0; i < count; ++i) {
+                if (codes[i].empty()) {
+                    missing.push_back(i);
+                    requests->push_back(
+                        { job->callsigns[i], &job->aircraft[i], &job->flightplans[i] });
+                }
+            }
+            if (missing.empty()) {
+                break;
+            }
+
+            auto call = std::async(std::launch::async, [state = &m_state, job, provider, requests] {
+                const AllocationScope scope(state);
+                return provider->GenerateSquawks(*requests);
+            });
+            if (job->deadline.count() > 0
+                && call.wait_for(job->deadline) == std::future_status::timeout) {
+                late.push_back(std::move(call));
+                continue;
+            }
+            std::vector<std::string> answers;
+            try {
+                answers = call.get();
+            } catch (...) {
+                continue;
+            }
+            const std::string name = provider->GetProviderName();
+            for (std::size_t k = 0; k < missing.size() && k < answers.size(); ++k) {
+                if (parseSquawk(answers[k])) {
+                    codes[missing[k]] = std::move(answers[k]);
+                    providerNames[missing[k]] = name;
+                }
+            }
+        }
+
+        // Delivered like recorded events, through trackEntities and the plugin's subscriptions
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!codes[i].empty()) {
+                m_state.postEvent(std::make_unique<HostSquawkAssigned>(
+                    job->callsigns[i], std::move(codes[i]), std::move(providerNames[i])));
+            }
+        }
+    }
+
+    State& m_state;
+    std::weak_ptr<State> m_weak;
+};
+
+class ReplayTagInterface : public Tag::TagInterface {
+public:
+    explicit ReplayTagInterface(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::string RegisterTagItem(const Tag::TagItemDefinition&) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        return nextId("tag");
+    }
+
+    std::string RegisterTagAction(const Tag::TagActionDefinition&) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        return nextId("action");
+    }
+
+    bool RegisterDataKey(const std::string& name) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        const DataKey key(name);
+        std::unique_lock lock(m_state.dataMutex);
+        const auto [it, inserted] = m_state.dataKeys.emplace(key.id, name);
+        return inserted || it->second == name;
+    }
+
+    std::string GetDataKeyName(DataKey key) const override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::shared_lock lock(m_state.dataMutex);
+        const auto it = m_state.dataKeys.find(key.id);
+        return it != m_state.dataKeys.end() ? it->second : std::string();
+    }
+
+    bool UpdateTagValue(
+        const std::string& tagId, const std::string& value, const Tag::TagContext& context) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        const Tag::TagValueUpdate update { tagId, context.callsign, value, context.colour,
+            context.backgroundColour };
+        std::unique_lock lock(m_state.dataMutex);
+        return apply(update) != Result::Failed;
+    }
+
+    Tag::TagValueUpdateResult UpdateTagValues(
+        const std::vector<Tag::TagValueUpdate>& updates) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        Tag::TagValueUpdateResult result;
+        std::unique_lock lock(m_state.dataMutex);
+        for (const Tag::TagValueUpdate& update : updates) {
+            switch (apply(update)) {
+            case Result::Applied:
+                ++result.applied;
+                break;
+            case Result::Unchanged:
+                ++result.unchanged;
+                break;
+            case Result::Failed:
+                ++result.failed;
+                break;
+            }
+        }
+        return result;
+    }
+
+    bool SetTagValueProvider(
+        const std::string& tagId, std::shared_ptr<Tag::TagValueProvider> provider) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        if (!provider) {
+            return false;
+        }
+        std::unique_lock lock(m_state.dataMutex);
+        m_state.tagProviders[tagId] = std::move(provider);
+        return true;
+    }
+
+    bool RemoveTagValueProvider(const std::string& tagId) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::unique_lock lock(m_state.dataMutex);
+        return m_state.tagProviders.erase(tagId) > 0;
+    }
+
+    void InvalidateTagValue(const std::string& tagId, const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::unique_lock lock(m_state.dataMutex);
+        m_state.tagValues.erase({ tagId, callsign });
+    }
+
+    void InvalidateTagValues(const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::unique_lock lock(m_state.dataMutex);
+        for (auto it = m_state.tagValues.begin(); it != m_state.tagValues.end();) {
+            it = it->first.second == callsign && m_state.tagProviders.count(it->first.first)
+                ? m_state.tagValues.erase(it)
+                : std::next(it);
+        }
+    }
+
+    bool SetActionDropdown(
+        const std::string& actionId, const Tag::DropdownDefinition& dropdown) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        ++m_state.counters.writes;
+        std::unique_lock lock(m_state.dataMutex);
+        m_state.dropdowns[actionId] = dropdown;
+        return true;
+    }
+
+    bool UpdateActionDropdown(
+        const std::string& actionId, const Tag::DropdownDefinition& dropdown) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::unique_lock lock(m_state.dataMutex);
+        const auto it = m_state.dropdowns.find(actionId);
+        if (it == m_state.dropdowns.end()) {
+            return false;
+        }
+        ++m_state.counters.writes;
+        it->second = dropdown;
+        return true;
+    }
+
+    std::size_t PatchActionDropdown(
+        const std::string& actionId, const std::vector<Tag::DropdownPatch>& patches) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::unique_lock lock(m_state.dataMutex);
+        const auto it = m_state.dropdowns.find(actionId);
+        if (it == m_state.dropdowns.end()) {
+            return 0;
+        }
+        ++m_state.counters.writes;
+        std::size_t applied = 0;
+        for (const Tag::DropdownPatch& patch : patches) {
+            applied += applyPatch(it->second, patch) ? 1 : 0;
+        }
+        return applied;
+    }
+
+    bool SetScrollAreaItemSource(const std::string& actionId, const std::string& componentId,
+        const Tag::VirtualScrollAreaDefinition& definition,
+        std::shared_ptr<Tag::DropdownItemSource> source) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        if (!source || definition.rowHeight <= 0) {
+            return false;
+        }
+        std::unique_lock lock(m_state.dataMutex);
+        m_state.scrollAreas[actionId][componentId]
+            = { definition, std::move(source), std::string(), 0, {} };
+        return true;
+    }
+
+    void InvalidateScrollAreaItems(
+        const std::string& actionId, const std::string& componentId) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::unique_lock lock(m_state.dataMutex);
+        const auto action = m_state.scrollAreas.find(actionId);
+        if (action == m_state.scrollAreas.end()) {
+            return;
+        }
+        const auto area = action->second.find(componentId);
+        if (area != action->second.end()) {
+            area->second.callsign.clear();
+            area->second.itemCount = 0;
+            area->second.rows.clear();
+        }
+    }
+
+    bool RemoveActionDropdown(const std::string& actionId) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::unique_lock lock(m_state.dataMutex);
+        m_state.scrollAreas.erase(actionId);
+        return m_state.dropdowns.erase(actionId) > 0;
+    }
+
+    bool GetDropdownForAction(
+        const std::string& actionId, Tag::DropdownDefinition& outDropdown) const override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Tag);
+        std::shared_lock lock(m_state.dataMutex);
+        const auto it = m_state.dropdowns.find(actionId);
+        if (it == m_state.dropdowns.end()) {
+            return false;
+        }
+        outDropdown = it->second;
+        const auto action = m_state.scrollAreas.find(actionId);
+        if (action == m_state.scrollAreas.end()) {
+            return true;
+        }
+        for (const auto& [componentId, area] : action->second) {
+            std::vector<Tag::DropdownComponent>* parent = nullptr;
+            std::size_t index = 0;
+            if (findComponent(outDropdown.components, componentId, parent, index)) {
+                (*parent)[index].children = area.rows;
+            }
+        }
+        return true;
+    }
+
+private:
+    enum class Result { Applied, Unchanged, Failed };
+
+    // Callers hold dataMutex exclusively
+    Result apply(const Tag::TagValueUpdate& update)
+    {
+        ++m_state.counters.tagUpdates;
+        if (update.tagId.empty() || update.callsign.empty()) {
+            return Result::Failed;
+        }
+        auto& current = m_state.tagValues[{ update.tagId, update.callsign }];
+        if (current.tagId == update.tagId && current.value == update.value
+            && current.colour == update.colour
+            && current.backgroundColour == update.backgroundColour) {
+            return Result::Unchanged;
+        }
+        current = update;
+        return Result::Applied;
+    }
+
+    std::string nextId(const char* prefix)
+    {
+        std::unique_lock lock(m_state.dataMutex);
+        return std::string(prefix) + "-" + std::to_string(m_state.nextTagId++);
+    }
+
+    State& m_state;
+};
+
+class ReplayTagAPI : public Tag::TagAPI {
+public:
+    explicit ReplayTagAPI(State& state)
+        : m_interface(state)
+    {
+    }
+
+    Tag::TagInterface* getInterface() override { return &m_interface; }
+
+private:
+    ReplayTagInterface m_interface;
+};
+
+class ReplayLoggerAPI : public Logger::LoggerAPI {
+public:
+    explicit ReplayLoggerAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    void log(Logger::LogLevel level, const std::string& message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        ++m_state.counters.logMessages;
+        if (isEnabled(level)) {
+            m_state.logLines.push("[plugin] " + message);
+        }
+    }
+
+    void fatal(const std::string& message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        log(Logger::LogLevel::Fatal, message);
+    }
+    void error(const std::string& message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        log(Logger::LogLevel::Error, message);
+    }
+    void warning(const std::string& message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        log(Logger::LogLevel::Warning, message);
+    }
+    void info(const std::string& message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        log(Logger::LogLevel::Info, message);
+    }
+    void debug(const std::string& message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        log(Logger::LogLevel::Debug, message);
+    }
+    void verbose(const std::string& message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        log(Logger::LogLevel::Verbose, message);
+    }
+
+    bool isEnabled(Logger::LogLevel level) const override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        return level <= m_state.logLevel;
+    }
+
+    std::uint64_t getDroppedMessageCount() const override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        std::lock_guard lock(m_state.logMutex);
+        return m_state.droppedLogMessages + m_state.logLines.dropped();
+    }
+
+    Logger::LogFormatId registerFormat(Logger::LogLevel level, std::string_view format) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        std::lock_guard lock(m_state.logMutex);
+        const auto id = static_cast<Logger::LogFormatId>(m_state.formats.size());
+        m_state.formats.emplace_back(level, std::string(format));
+        if (m_state.binaryLog.isOpen()) {
+            m_state.binaryLog.writeFormat(id, level, format);
+        }
+        return id;
+    }
+
+    void logStructured(
+        Logger::LogFormatId formatId, const Logger::LogArgument* args, std::size_t count) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        std::unique_lock lock(m_state.logMutex);
+        if (formatId >= m_state.formats.size()) {
+            return;
+        }
+        ++m_state.counters.logMessages;
+        if (!isEnabled(m_state.formats[formatId].first)) {
+            return;
+        }
+        if (m_state.binaryLog.isOpen()) {
+            if (!m_state.binaryLog.writeMessage(formatId, args, count, m_state.formats)) {
+                ++m_state.droppedLogMessages;
+            }
+            return;
+        }
+        const std::string format = m_state.formats[formatId].second;
+        lock.unlock();
+
+        std::ostringstream out;
+        std::size_t position = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto placeholder = format.find("{}", position);
+            if (placeholder == std::string::npos) {
+                break;
+            }
+            out << std::string_view(format).substr(position, placeholder - position);
+            switch (args[i].type) {
+            case Logger::LogArgumentType::Int:
+                out << args[i].i;
+                break;
+            case Logger::LogArgumentType::UInt:
+                out << args[i].u;
+                break;
+            case Logger::LogArgumentType::Double:
+                out << args[i].d;
+                break;
+            case Logger::LogArgumentType::Bool:
+                out << (args[i].b ? "true" : "false");
+                break;
+            case Logger::LogArgumentType::String:
+                out << args[i].s;
+                break;
+            }
+            position = placeholder + 2;
+        }
+        out << std::string_view(format).substr(position);
+        m_state.logLines.push("[plugin] " + out.str());
+    }
+
+    bool setBinaryLogging(const Logger::BinaryLogOptions& options) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Logger);
+        std::lock_guard lock(m_state.logMutex);
+        if (!options.enabled) {
+            m_state.binaryLog.close();
+            return true;
+        }
+        return m_state.binaryLog.open(options, m_state.formats);
+    }
+
+private:
+    State& m_state;
+};
+
+class ReplayFsdAPI : public Fsd::FsdAPI {
+public:
+    explicit ReplayFsdAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    std::optional<Fsd::ConnectionInfo> getConnection() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Fsd);
+        return m_state.copy(m_state.snapshot.connection);
+    }
+
+    // Raw packets are not part of recordings, so subscribers never receive any
+    std::unique_ptr<Fsd::RegistrationToken> subscribePackets(const std::vector<std::string>&,
+        bool, std::shared_ptr<Fsd::FsdPacketListener> listener) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Fsd);
+        if (!listener) {
+            return nullptr;
+        }
+        return std::make_unique<Token<Fsd::RegistrationToken>>(nullptr);
+    }
+
+private:
+    State& m_state;
+};
+
+class ReplayChatAPI : public Chat::ChatAPI {
+public:
+    ReplayChatAPI(State& state, std::weak_ptr<State> weak)
+        : m_state(state)
+        , m_weak(std::move(weak))
+    {
+    }
+
+    std::string registerCommand(const std::string& name,
+        const Chat::CommandDefinition& definition,
+        std::shared_ptr<Chat::CommandProvider> provider) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        if (name.empty() || !provider || std::any_of(name.begin(), name.end(), isSpace)
+            || isReservedCommand(name) || !isValidDefinition(definition)) {
+            return {};
+        }
+        std::lock_guard lock(m_state.messageMutex);
+        if (m_state.commands.count(name)) {
+            return {};
+        }
+        std::string id = "command-" + std::to_string(m_state.nextCommandId++);
+        m_state.commands[name] = { id, definition, std::move(provider) };
+        return id;
+    }
+
+    bool unregisterCommand(const std::string& commandId) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        std::lock_guard lock(m_state.messageMutex);
+        for (auto it = m_state.commands.begin(); it != m_state.commands.end(); ++it) {
+            if (it->second.id == commandId) {
+                m_state.commands.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::string> completeCommand(
+        const std::string& prefix, std::size_t maxResults) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        std::vector<std::string> names;
+        std::lock_guard lock(m_state.messageMutex);
+        for (auto it = m_state.commands.lower_bound(prefix);
+             it != m_state.commands.end() && names.size() < maxResults
+             && it->first.compare(0, prefix.size(), prefix) == 0;
+             ++it) {
+            names.push_back(it->first);
+        }
+        return names;
+    }
+
+    void sendClientMessage(const Chat::ClientTextMessageEvent) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        ++m_state.counters.messagesSent;
+    }
+
+    bool queueClientMessage(Chat::ClientTextMessageEvent message) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        if (message.isUrgent) {
+            ++m_state.counters.messagesSent;
+            return true;
+        }
+        const std::chrono::nanoseconds now = m_state.currentTime();
+        std::lock_guard lock(m_state.messageMutex);
+        auto& queue = m_state.clientQueue;
+        const auto channel = std::find_if(queue.rbegin(), queue.rend(),
+            [&](const QueuedClientMessage& queued) {
+                return queued.message.sentFrom == message.sentFrom
+                    && queued.message.useDedicatedChannel == message.useDedicatedChannel;
+            });
+        if (channel != queue.rend() && now - channel->queued < m_state.queueOptions.mergeWindow) {
+            channel->message.message += '\n';
+            channel->message.message += message.message;
+            ++m_state.queueStats.merged;
+            return true;
+        }
+        if (queue.size() >= m_state.queueOptions.capacity) {
+            ++m_state.queueStats.dropped;
+            return false;
+        }
+        queue.push_back({ std::move(message), now });
+        return true;
+    }
+
+    void setClientMessageQueueOptions(const Chat::ClientMessageQueueOptions& options) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        std::lock_guard lock(m_state.messageMutex);
+        m_state.queueOptions = options;
+    }
+
+    Chat::ClientMessageQueueStats getClientMessageQueueStats() override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        std::lock_guard lock(m_state.messageMutex);
+        Chat::ClientMessageQueueStats stats = m_state.queueStats;
+        stats.depth = m_state.clientQueue.size();
+        stats.capacity = m_state.queueOptions.capacity;
+        return stats;
+    }
+
+    std::unique_ptr<Chat::RegistrationToken> subscribeMessages(
+        Chat::MessageChannel channel, const Chat::MessageFilter& filter) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        MessageSubscription subscription { 0, channel, filter, {} };
+        if (filter.pattern) {
+            try {
+                subscription.pattern.emplace(*filter.pattern, std::regex::ECMAScript);
+            } catch (const std::regex_error&) {
+                return nullptr;
+            }
+        }
+        std::lock_guard lock(m_state.messageMutex);
+        const std::uint64_t id = subscription.id = m_state.nextSubscriptionId++;
+        m_state.subscriptions.push_back(std::move(subscription));
+        return std::make_unique<Token<Chat::RegistrationToken>>([weak = m_weak, id] {
+            if (auto state = weak.lock()) {
+                std::lock_guard lock(state->messageMutex);
+                auto& subscriptions = state->subscriptions;
+                subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                        [&](const auto& s) { return s.id == id; }),
+                    subscriptions.end());
+            }
+        });
+    }
+
+    std::vector<Chat::ChatHistoryEntry> queryHistory(const Chat::ChatHistoryQuery& query) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Chat);
+        ++m_state.counters.queries;
+        std::lock_guard lock(m_state.messageMutex);
+        return m_state.history.query(query);
+    }
+
+private:
+    State& m_state;
+    std::weak_ptr<State> m_weak;
+};
+
+class ReplayComponentAPI : public Component::ComponentAPI {
+public:
+    explicit ReplayComponentAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    Component::ComponentId registerComponent(
+        Component::EntityKind kind, const Component::ComponentType& type) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Component);
+        const bool powerOfTwo = type.alignment != 0 && (type.alignment & (type.alignment - 1)) == 0;
+        if (type.size == 0 || !powerOfTwo || !type.construct || !type.destroy
+            || static_cast<std::size_t>(kind) >= m_state.entities.size()) {
+            return 0;
+        }
+        EntityTable& table = m_state.entityTable(kind);
+        m_state.components.emplace_back(&table, &table.addColumn(type));
+        return static_cast<Component::ComponentId>(m_state.components.size());
+    }
+
+    Component::EntityHandle findEntity(
+        Component::EntityKind kind, const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Component);
+        ++m_state.counters.queries;
+        if (static_cast<std::size_t>(kind) >= m_state.entities.size()) {
+            return {};
+        }
+        return m_state.entityTable(kind).find(callsign);
+    }
+
+    void* getComponent(Component::ComponentId id, Component::EntityHandle entity) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Component);
+        if (id == 0 || id > m_state.components.size()) {
+            return nullptr;
+        }
+        const auto [table, column] = m_state.components[id - 1];
+        return table->component(*column, entity);
+    }
+
+    void* getComponent(Component::ComponentId id, const std::string& callsign) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Component);
+        if (id == 0 || id > m_state.components.size()) {
+            return nullptr;
+        }
+        const auto [table, column] = m_state.components[id - 1];
+        return table->component(*column, table->find(callsign));
+    }
+
+    void forEachComponent(Component::ComponentId id,
+        const std::function<void(const std::string& callsign, void* component)>& function) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Component);
+        if (id == 0 || id > m_state.components.size() || !function) {
+            return;
+        }
+        const auto [table, column] = m_state.components[id - 1];
+        table->forEach(*column, function);
+    }
+
+private:
+    State& m_state;
+};
+
+class ReplaySchedulerAPI : public Scheduler::SchedulerAPI {
+public:
+    ReplaySchedulerAPI(State& state, std::weak_ptr<State> weak)
+        : m_state(state)
+        , m_weak(std::move(weak))
+        , m_pool(std::max(std::thread::hardware_concurrency(), 2u) - 1,
+              [&state](const std::string& what) {
+                  ++state.taskExceptions;
+                  state.logHost(Logger::LogLevel::Error, "pool task threw: " + what);
+              })
+    {
+        state.workers = &m_pool;
+    }
+
+    void post(Scheduler::Task task) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        if (task) {
+            m_pool.post([state = &m_state, task = std::move(task)] {
+                const AllocationScope scope(state);
+                task();
+            });
+        }
+    }
+
+    void postToMain(Scheduler::Task task) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        if (task) {
+            std::lock_guard lock(m_state.pendingMutex);
+            m_state.pending.push_back(std::move(task));
+        }
+    }
+
+    void parallelFor(std::size_t count,
+        const std::function<void(std::size_t begin, std::size_t end)>& body,
+        std::size_t grainSize) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        if (count == 0) {
+            return;
+        }
+        const std::size_t threads = m_pool.size() + 1;
+        const std::size_t grain
+            = grainSize ? grainSize : std::max<std::size_t>(1, count / (threads * 4));
+        const std::size_t ranges = (count + grain - 1) / grain;
+
+        // Helpers and the caller claim ranges until none are left, so the
+        // caller finishes the loop alone if every pool thread is busy. A range
+        // that throws still counts as done, so the wait below always ends.
+        struct Loop {
+            std::atomic<std::size_t> next { 0 };
+            std::atomic<std::size_t> done { 0 };
+            std::atomic<bool> failed { false };
+            std::mutex mutex;
+            std::condition_variable finished;
+            // First exception thrown by body, guarded by mutex
+            std::exception_ptr error;
+        };
+        auto loop = std::make_shared<Loop>();
+        auto work = [loop, &body, count, grain, ranges, state = &m_state] {
+            const AllocationScope scope(state);
+            for (std::size_t range; (range = loop->next++) < ranges;) {
+                const std::size_t begin = range * grain;
+                if (!loop->failed) {
+                    try {
+                        body(begin, std::min(begin + grain, count));
+                    } catch (...) {
+                        std::lock_guard lock(loop->mutex);
+                        if (!loop->error) {
+                            loop->error = std::current_exception();
+                        }
+                        loop->failed = true;
+                    }
+                }
+                if (++loop->done == ranges) {
+                    std::lock_guard lock(loop->mutex);
+                    loop->finished.notify_all();
+                }
+            }
+        };
+        for (std::size_t i = 1; i < std::min(threads, ranges); ++i) {
+            m_pool.post(work);
+        }
+        work();
+
+        std::unique_lock lock(loop->mutex);
+        loop->finished.wait(lock, [&] { return loop->done == ranges; });
+        if (loop->error) {
+            std::rethrow_exception(loop->error);
+        }
+    }
+
+    std::unique_ptr<Scheduler::RegistrationToken> addTimer(
+        std::chrono::milliseconds interval, Scheduler::Task task, bool repeat) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        if (!task) {
+            return nullptr;
+        }
+        std::lock_guard lock(m_state.timerMutex);
+        const std::chrono::nanoseconds period = std::max(interval, std::chrono::milliseconds(1));
+        const std::uint64_t id = m_state.nextTimerId++;
+        m_state.timers[id] = { period, m_state.now + period, std::move(task), repeat, {} };
+        return std::make_unique<Token<Scheduler::RegistrationToken>>([weak = m_weak, id] {
+            if (auto state = weak.lock()) {
+                std::lock_guard lock(state->timerMutex);
+                state->timers.erase(id);
+            }
+        });
+    }
+
+    std::unique_ptr<Scheduler::RegistrationToken> waitForEvent(EventType type,
+        std::function<bool(const void* event)> filter,
+        std::function<void(const void* event)> callback) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        if (type >= EventType::TagShowDropdown || !callback) {
+            return nullptr;
+        }
+        std::lock_guard lock(m_state.waiterMutex);
+        const std::uint64_t id = m_state.nextWaiterId++;
+        m_state.waited.set(type);
+        m_state.waiters[static_cast<std::size_t>(type)][id]
+            = std::make_shared<EventWaiter>(EventWaiter { std::move(filter), std::move(callback) });
+        return std::make_unique<Token<Scheduler::RegistrationToken>>([weak = m_weak, type, id] {
+            if (auto state = weak.lock()) {
+                std::lock_guard lock(state->waiterMutex);
+                state->waiters[static_cast<std::size_t>(type)].erase(id);
+            }
+        });
+    }
+
+    std::unique_ptr<Scheduler::RegistrationToken> waitForDelay(
+        std::chrono::milliseconds delay, std::function<void(bool cancelled)> callback) override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        if (!callback) {
+            return nullptr;
+        }
+        auto shared = std::make_shared<std::function<void(bool)>>(std::move(callback));
+        std::lock_guard lock(m_state.timerMutex);
+        const std::chrono::nanoseconds period = std::max(delay, std::chrono::milliseconds(1));
+        const std::uint64_t id = m_state.nextTimerId++;
+        m_state.timers[id] = { period, m_state.now + period, [shared] { (*shared)(false); },
+            false, [shared] { (*shared)(true); } };
+        return std::make_unique<Token<Scheduler::RegistrationToken>>([weak = m_weak, id] {
+            if (auto state = weak.lock()) {
+                std::lock_guard lock(state->timerMutex);
+                state->timers.erase(id);
+            }
+        });
+    }
+
+    std::chrono::milliseconds getTickInterval() const override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        std::lock_guard lock(m_state.timerMutex);
+        return m_state.tickInterval;
+    }
+
+    std::size_t getWorkerCount() const override
+    {
+        const ApiCallTimer timer(m_state, Metrics::Api::Scheduler);
+        return m_pool.size();
+    }
+
+    void waitForIdle() { m_pool.waitForIdle(); }
+
+private:
+    State& m_state;
+    std::weak_ptr<State> m_weak;
+    ThreadPool m_pool;
+};
+
+class ReplayMetricsAPI : public Metrics::MetricsAPI {
+public:
+    explicit ReplayMetricsAPI(State& state)
+        : m_state(state)
+    {
+    }
+
+    Metrics::PluginMetrics getMetrics() override { return collectMetrics(m_state); }
+
+    void resetMetrics() override { Replay::resetMetrics(m_state); }
+
+private:
+    State& m_state;
+};
+
+// Current event of a reader, dispatched without copying it; take() hands it
+// over for events that must outlive the record, such as batched ones
+struct ReaderEvent {
+    Recording::RecordingReader& reader;
+
+    EventType type() const { return reader.eventType(); }
+    const void* data() const { return reader.event(); }
+    void dispatch(BasePlugin& plugin) const { reader.dispatch(plugin); }
+    std::unique_ptr<Recording::RecordedEvent> take() const { return reader.takeEvent(); }
+};
+
+// Event already owned by the host, e.g. queued by the isolated dispatcher
+struct OwnedEvent {
+    std::unique_ptr<Recording::RecordedEvent>& event;
+
+    EventType type() const { return event->type(); }
+    const void* data() const { return event->data(); }
+    void dispatch(BasePlugin& plugin) const { event->dispatch(plugin); }
+    std::unique_ptr<Recording::RecordedEvent> take() const { return std::move(event); }
+};
+
+// Collects the batched events of one tick. The batcher takes the decoded
+// events over instead of copying their payloads, and keeps them until
+// OnEventBatch returns.
+class EventBatcher {
+public:
+    bool empty() const { return m_events.empty(); }
+    std::uint64_t tick() const { return m_tick; }
+
+    void add(std::unique_ptr<Recording::RecordedEvent> event, std::uint64_t tick)
+    {
+        m_tick = tick;
+        m_events.push_back({ event->type(), event->data() });
+        m_owned.push_back(std::move(event));
+    }
+
+    void flush(BasePlugin& plugin)
+    {
+        plugin.OnEventBatch(EventBatch(m_events.data(), m_events.size(), m_tick));
+    }
+
+    void clear()
+    {
+        m_events.clear();
+        m_owned.clear();
+    }
+
+private:
+    std::vector<BatchedEvent> m_events;
+    std::vector<std::unique_ptr<Recording::RecordedEvent>> m_owned;
+    std::uint64_t m_tick = 0;
+};
+
+// Events creating or removing the entity records components attach to, or
+// changing the squawk codes in use, read whether or not the plugin subscribes to them
+constexpr EventMask EntityEvents { EventType::AircraftConnected, EventType::AircraftDisconnected,
+    EventType::FlightplanUpdated, EventType::FlightplanRemoved, EventType::ControllerConnected,
+    EventType::ControllerDisconnected, EventType::AircraftBeaconCodeChanged,
+    EventType::SquawkAssigned };
+
+void mergePositionUpdate(
+    Aircraft::PositionUpdateEvent& queued, const Aircraft::PositionUpdateEvent& update)
+{
+    for (const Aircraft::Aircraft& aircraft : update.aircrafts) {
+        const auto existing = std::find_if(queued.aircrafts.begin(), queued.aircrafts.end(),
+            [&](const Aircraft::Aircraft& a) { return a.callsign == aircraft.callsign; });
+        if (existing != queued.aircrafts.end()) {
+            *existing = aircraft;
+        } else {
+            queued.aircrafts.push_back(aircraft);
+        }
+    }
+}
+
+// Worker thread and bounded queue of a plugin using DispatchMode::Isolated
+class IsolatedDispatcher {
+public:
+    // May take the event over, e.g. to batch it
+    using DispatchFunction = std::function<void(
+        std::unique_ptr<Recording::RecordedEvent>&, std::chrono::nanoseconds)>;
+    using AdvanceFunction = std::function<void(std::chrono::nanoseconds)>;
+
+    IsolatedDispatcher(ReplayHost& host, const Dispatch::DispatchOptions& options,
+        DispatchFunction dispatch, AdvanceFunction advance)
+        : m_host(host)
+        , m_options(options)
+        , m_dispatch(std::move(dispatch))
+        , m_advance(std::move(advance))
+    {
+        m_options.capacity = std::max<std::size_t>(m_options.capacity, 1);
+        m_stats.mode = Dispatch::DispatchMode::Isolated;
+        m_stats.capacity = m_options.capacity;
+        m_worker = std::thread([this] { run(); });
+    }
+
+    ~IsolatedDispatcher() { finish(); }
+
+    // Snapshots are applied in order with the events but do not use capacity
+    void push(std::shared_ptr<const Recording::Snapshot> snapshot)
+    {
+        std::lock_guard lock(m_mutex);
+        m_queue.push_back({ nullptr, std::move(snapshot), {}, Clock::now() });
+        m_notEmpty.notify_one();
+    }
+
+    // Advances the clock on the worker when no event is dispatched for a tick
+    void pushTick(std::chrono::nanoseconds timestamp)
+    {
+        std::lock_guard lock(m_mutex);
+        m_queue.push_back({ nullptr, nullptr, timestamp, Clock::now() });
+        m_notEmpty.notify_one();
+    }
+
+    void push(std::unique_ptr<Recording::RecordedEvent> event, std::chrono::nanoseconds timestamp)
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_options.policy == Dispatch::QueuePolicy::Merge
+            && event->type() == EventType::PositionUpdate && merge(*event)) {
+            ++m_stats.merged;
+            return;
+        }
+
+        if (m_events >= m_options.capacity) {
+            if (m_options.policy == Dispatch::QueuePolicy::DropOldest) {
+                const auto oldest = std::find_if(m_queue.begin(), m_queue.end(),
+                    [](const Item& item) { return item.event != nullptr; });
+                m_queue.erase(oldest);
+                --m_events;
+                ++m_stats.dropped;
+            } else {
+                const auto before = Clock::now();
+                m_notFull.wait(lock, [this] { return m_events < m_options.capacity; });
+                m_stats.blocked += Clock::now() - before;
+            }
+        }
+
+        m_queue.push_back({ std::move(event), nullptr, timestamp, Clock::now() });
+        ++m_events;
+        m_stats.maxQueueDepth = std::max(m_stats.maxQueueDepth, m_events);
+        m_notEmpty.notify_one();
+    }
+
+    // Deliver the queued events and stop the worker
+    void finish()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+            m_notEmpty.notify_one();
+        }
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+    }
+
+    Dispatch::DispatchStats stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        Dispatch::DispatchStats stats = m_stats;
+        stats.queueDepth = m_events;
+        stats.lag = m_queue.empty() ? std::chrono::nanoseconds(0)
+                                    : Clock::now() - m_queue.front().enqueued;
+        return stats;
+    }
+
+private:
+    struct Item {
+        std::unique_ptr<Recording::RecordedEvent> event;
+        std::shared_ptr<const Recording::Snapshot> snapshot;
+        std::chrono::nanoseconds timestamp;
+        Clock::time_point enqueued;
+    };
+
+    // Merge into the newest queued item if it is a PositionUpdate. Merging past
+    // any other item would deliver positions before events recorded earlier.
+    bool merge(const Recording::RecordedEvent& event)
+    {
+        if (m_queue.empty() || !m_queue.back().event
+            || m_queue.back().event->type() != EventType::PositionUpdate) {
+            return false;
+        }
+        mergePositionUpdate(
+            *static_cast<Aircraft::PositionUpdateEvent*>(m_queue.back().event->data()),
+            *static_cast<const Aircraft::PositionUpdateEvent*>(event.data()));
+        return true;
+    }
+
+    void run()
+    {
+        for (;;) {
+            Item item;
+            {
+                std::unique_lock lock(m_mutex);
+                m_notEmpty.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+                if (m_queue.empty()) {
+                    return;
+                }
+                item = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_stats.maxLag = std::max<std::chrono::nanoseconds>(
+                    m_stats.maxLag, Clock::now() - item.enqueued);
+                if (item.event) {
+                    --m_events;
+                    m_notFull.notify_one();
+                }
+            }
+
+            if (item.snapshot) {
+                m_host.setSnapshot(*item.snapshot);
+                continue;
+            }
+            if (!item.event) {
+                m_advance(item.timestamp);
+                continue;
+            }
+            m_dispatch(item.event, item.timestamp);
+
+            std::lock_guard lock(m_mutex);
+            ++m_stats.dispatched;
+        }
+    }
+
+    ReplayHost& m_host;
+    Dispatch::DispatchOptions m_options;
+    DispatchFunction m_dispatch;
+    AdvanceFunction m_advance;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<Item> m_queue;
+    std::size_t m_events = 0;
+    bool m_stopping = false;
+    Dispatch::DispatchStats m_stats;
+    std::thread m_worker;
+};
+
+} // namespace
+
+struct ReplayHost::Impl {
+    std::shared_ptr<State> state = std::make_shared<State>();
+    ReplayPackageAPI package { *state };
+    ReplayAircraftAPI aircraft { *state };
+    ReplayFlightplanAPI flightplan { *state };
+    ReplayControllerAPI controller { *state };
+    ReplayControllerDataAPI controllerData { *state };
+    ReplayAirportAPI airport { *state };
+    ReplaySquawkAPI squawk { *state, state };
+    ReplayTagAPI tag { *state };
+    ReplayLoggerAPI logger { *state };
+    ReplayFsdAPI fsd { *state };
+    ReplayChatAPI chat { *state, state };
+    ReplayComponentAPI component { *state };
+    ReplayMetricsAPI metrics { *state };
+    // Last, so pool tasks finish before the other APIs are destroyed
+    ReplaySchedulerAPI scheduler { *state, state };
+};
+
+ReplayHost::ReplayHost()
+    : m_impl(std::make_unique<Impl>())
+{
+}
+
+ReplayHost::~ReplayHost() = default;
+
+void ReplayHost::setPlugin(BasePlugin* plugin) { m_impl->state->plugin = plugin; }
+
+void ReplayHost::setSnapshot(const Recording::Snapshot& snapshot)
+{
+    State& state = *m_impl->state;
+    std::unique_lock lock(state.dataMutex);
+    state.snapshot = snapshot;
+    State::index(state.snapshot.aircraft, state.aircraftIndex, &Aircraft::Aircraft::callsign);
+    State::index(
+        state.snapshot.flightplans, state.flightplanIndex, &Flightplan::Flightplan::callsign);
+    State::index(
+        state.snapshot.controllers, state.controllerIndex, &Controller::Controller::callsign);
+    State::index(state.snapshot.controllerData, state.controllerDataIndex,
+        &ControllerData::ControllerDataModel::callsign);
+    State::index(state.snapshot.airports, state.airportIndex, &Airport::AirportConfig::icao);
+    state.aircraftChanges.update(state.snapshot.aircraft, &Aircraft::Aircraft::callsign);
+    state.flightplanChanges.update(state.snapshot.flightplans, &Flightplan::Flightplan::callsign);
+    state.controllerChanges.update(state.snapshot.controllers, &Controller::Controller::callsign);
+    state.controllerDataChanges.update(
+        state.snapshot.controllerData, &ControllerData::ControllerDataModel::callsign);
+    state.airportChanges.update(state.snapshot.airports, &Airport::AirportConfig::icao);
+    state.entityTable(Component::EntityKind::Aircraft)
+        .sync(state.snapshot.aircraft, &Aircraft::Aircraft::callsign);
+    std::vector<Squawk::DuplicateSquawkEvent> duplicates;
+    state.squawkPool.dropHoldersExcept(
+        [&](const std::string& callsign) { return state.aircraftIndex.count(callsign) > 0; },
+        duplicates);
+    for (const Aircraft::Aircraft& aircraft : state.snapshot.aircraft) {
+        state.squawkPool.hold(aircraft.callsign, parseSquawk(aircraft.squawk), duplicates);
+    }
+    state.postDuplicates(duplicates);
+    state.entityTable(Component::EntityKind::Flightplan)
+        .sync(state.snapshot.flightplans, &Flightplan::Flightplan::callsign);
+    state.entityTable(Component::EntityKind::Controller)
+        .sync(state.snapshot.controllers, &Controller::Controller::callsign);
+}
+
+bool ReplayHost::receiveMessage(EventType type, const void* event)
+{
+    State& state = *m_impl->state;
+    const auto message = toReceivedMessage(type, event);
+    if (!message) {
+        return true;
+    }
+
+    std::lock_guard lock(state.messageMutex);
+    Chat::ChatHistoryEntry entry;
+    entry.sequence = state.nextSequence++;
+    entry.channel = message->channel;
+    entry.sentFrom = *message->sentFrom;
+    entry.sentTo = message->sentTo ? *message->sentTo : std::string();
+    entry.message = *message->message;
+    entry.frequencies = message->frequencies ? *message->frequencies : std::vector<int>();
+    entry.fromMe = message->fromMe;
+    state.history.add(std::move(entry));
+
+    return std::any_of(state.subscriptions.begin(), state.subscriptions.end(),
+        [&](const MessageSubscription& subscription) { return matches(subscription, *message); });
+}
+
+std::optional<Chat::CommandResult> ReplayHost::executeCommand(const std::string& line)
+{
+    State& state = *m_impl->state;
+    std::string_view text = trim(line);
+    if (!text.empty() && text.front() == '.') {
+        text.remove_prefix(1);
+    }
+    const auto nameEnd = std::find_if(text.begin(), text.end(), isSpace);
+    const std::string name(text.begin(), nameEnd);
+    // Copied, as the provider may unregister the command while it runs
+    RegisteredCommand registered;
+    {
+        std::lock_guard lock(state.messageMutex);
+        const auto command = state.commands.find(name);
+        if (command == state.commands.end()) {
+            return std::nullopt;
+        }
+        registered = command->second;
+    }
+
+    // Arguments view the line, which outlives the call
+    const std::string_view rest = text.substr(name.size());
+    std::vector<Chat::CommandArgument> arguments;
+    if (const auto error = parseArguments(registered.definition, rest, arguments)) {
+        return Chat::CommandResult { false, "." + name + ": " + *error };
+    }
+    const AllocationScope scope(&state);
+    return registered.provider->ExecuteParsed(registered.id,
+        { trim(rest), arguments.data(), arguments.size() });
+}
+
+void ReplayHost::processPending()
+{
+    State& state = *m_impl->state;
+    std::vector<std::function<void()>> pending;
+    {
+        std::lock_guard lock(state.pendingMutex);
+        pending.swap(state.pending);
+    }
+    const AllocationScope scope(&state);
+    for (auto& work : pending) {
+        work();
+    }
+}
+
+void ReplayHost::showDropdown(const std::string& actionId, const std::string& callsign)
+{
+    State& state = *m_impl->state;
+    struct Fetch {
+        std::string componentId;
+        std::shared_ptr<Tag::DropdownItemSource> source;
+        std::size_t rows;
+    };
+    std::vector<Fetch> fetches;
+    {
+        std::shared_lock lock(state.dataMutex);
+        const auto action = state.scrollAreas.find(actionId);
+        const auto dropdown = state.dropdowns.find(actionId);
+        if (action == state.scrollAreas.end() || dropdown == state.dropdowns.end()) {
+            return;
+        }
+        const Tag::DropdownDefinition& definition = dropdown->second;
+        for (const auto& [componentId, area] : action->second) {
+            const std::vector<Tag::DropdownComponent>* parent = nullptr;
+            std::size_t index = 0;
+            if (area.callsign == callsign
+                || !findComponent(definition.components, componentId, parent, index)) {
+                continue;
+            }
+            // The scroll area fills the dropdown unless its style gives it a height
+            const int height = (*parent)[index].style.height.value_or(definition.maxHeight);
+            const int rowHeight = area.definition.rowHeight;
+            const auto visible
+                = static_cast<std::size_t>((std::max(height, 0) + rowHeight - 1) / rowHeight);
+            fetches.push_back({ componentId, area.source, visible + area.definition.prefetchRows });
+        }
+    }
+
+    // Item sources are plugin code, so they run unlocked and may call the tag API
+    for (const Fetch& fetch : fetches) {
+        const std::size_t itemCount
+            = fetch.source->GetItemCount(actionId, fetch.componentId, callsign);
+        std::vector<Tag::DropdownComponent> rows;
+        const Tag::DropdownItemRange range { actionId, fetch.componentId, callsign, 0,
+            std::min(itemCount, fetch.rows) };
+        if (range.count > 0) {
+            fetch.source->GetItems(range, rows);
+        }
+
+        std::unique_lock lock(state.dataMutex);
+        const auto action = state.scrollAreas.find(actionId);
+        if (action == state.scrollAreas.end()) {
+            return;
+        }
+        const auto area = action->second.find(fetch.componentId);
+        if (area != action->second.end() && area->second.source == fetch.source) {
+            area->second.callsign = callsign;
+            area->second.itemCount = itemCount;
+            area->second.rows = std::move(rows);
+        }
+    }
+}
+
+void ReplayHost::renderTags()
+{
+    State& state = *m_impl->state;
+    struct Poll {
+        std::shared_ptr<Tag::TagValueProvider> provider;
+        std::vector<Tag::TagValueRequest> requests;
+    };
+    std::vector<Poll> polls;
+    {
+        std::shared_lock lock(state.dataMutex);
+        for (const auto& [tagId, provider] : state.tagProviders) {
+            auto poll = std::find_if(polls.begin(), polls.end(),
+                [&](const Poll& candidate) { return candidate.provider == provider; });
+            for (const Aircraft::Aircraft& aircraft : state.snapshot.aircraft) {
+                if (state.tagValues.count({ tagId, aircraft.callsign })) {
+                    continue;
+                }
+                if (poll == polls.end()) {
+                    poll = polls.insert(polls.end(), { provider, {} });
+                }
+                poll->requests.push_back({ tagId, aircraft.callsign, std::string() });
+            }
+        }
+    }
+
+    // Providers are plugin code, so they run unlocked and may call the tag API
+    for (const Poll& poll : polls) {
+        std::vector<Tag::TagValueUpdate> values;
+        {
+            const AllocationScope scope(&state);
+            poll.provider->ProvideTagValues(poll.requests, values);
+        }
+
+        std::unique_lock lock(state.dataMutex);
+        for (Tag::TagValueUpdate& value : values) {
+            const auto provider = state.tagProviders.find(value.tagId);
+            if (provider != state.tagProviders.end() && provider->second == poll.provider
+                && !value.callsign.empty()) {
+                state.tagValues[{ value.tagId, value.callsign }] = std::move(value);
+            }
+        }
+    }
+}
+
+void ReplayHost::advanceTo(std::chrono::nanoseconds time)
+{
+    State& state = *m_impl->state;
+    std::vector<std::function<void()>> due;
+    {
+        std::lock_guard lock(state.timerMutex);
+        if (time <= state.now) {
+            return;
+        }
+        state.now = time;
+        const std::chrono::nanoseconds tick = state.tickInterval;
+        const std::chrono::nanoseconds tickTime = time - time % tick;
+        for (auto it = state.timers.begin(); it != state.timers.end();) {
+            Timer& timer = it->second;
+            if (timer.deadline > tickTime) {
+                ++it;
+                continue;
+            }
+            due.push_back(timer.task);
+            if (!timer.repeat) {
+                it = state.timers.erase(it);
+                continue;
+            }
+            // Missed runs collapse into this one
+            const auto missed = (tickTime - timer.deadline) / timer.interval;
+            timer.deadline += (missed + 1) * timer.interval;
+            ++it;
+        }
+    }
+    {
+        const AllocationScope scope(&state);
+        for (auto& task : due) {
+            task();
+        }
+    }
+
+    sendClientMessages(state, time);
+
+    if (state.metricsInterval.count() > 0
+        && time - state.lastMetricsDump >= state.metricsInterval) {
+        state.lastMetricsDump = time;
+        std::istringstream dump(formatMetrics(collectMetrics(state)));
+        for (std::string line; std::getline(dump, line);) {
+            state.logHost(Logger::LogLevel::Info, line);
+        }
+    }
+}
+
+EventMask ReplayHost::getWaitedEvents() const
+{
+    State& state = *m_impl->state;
+    std::lock_guard lock(state.waiterMutex);
+    return state.waited;
+}
+
+bool ReplayHost::hasWaiters(EventType type) const
+{
+    State& state = *m_impl->state;
+    std::lock_guard lock(state.waiterMutex);
+    return type < EventType::Count && !state.waiters[static_cast<std::size_t>(type)].empty();
+}
+
+void ReplayHost::notifyWaiters(EventType type, const void* event)
+{
+    if (!hasWaiters(type)) {
+        return;
+    }
+    State& state = *m_impl->state;
+    auto& waiters = state.waiters[static_cast<std::size_t>(type)];
+
+    // Callbacks run unlocked: they may wait again or cancel other waits
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<EventWaiter>>> candidates;
+    {
+        std::lock_guard lock(state.waiterMutex);
+        candidates.assign(waiters.begin(), waiters.end());
+    }
+    for (const auto& [id, waiter] : candidates) {
+        if (waiter->filter && !waiter->filter(event)) {
+            continue;
+        }
+        {
+            std::lock_guard lock(state.waiterMutex);
+            if (waiters.erase(id) == 0) {
+                continue;
+            }
+        }
+        const AllocationScope scope(&state);
+        waiter->callback(event);
+    }
+}
+
+void ReplayHost::cancelWaits()
+{
+    State& state = *m_impl->state;
+    // Unwinding coroutines may wait again; those waits are cancelled too
+    for (;;) {
+        std::vector<std::shared_ptr<EventWaiter>> waiters;
+        std::vector<std::function<void()>> delays;
+        {
+            std::lock_guard lock(state.waiterMutex);
+            for (auto& byType : state.waiters) {
+                for (auto& [id, waiter] : byType) {
+                    waiters.push_back(std::move(waiter));
+                }
+                byType.clear();
+            }
+        }
+        {
+            std::lock_guard lock(state.timerMutex);
+            for (auto it = state.timers.begin(); it != state.timers.end();) {
+                if (it->second.cancel) {
+                    delays.push_back(std::move(it->second.cancel));
+                    it = state.timers.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        if (waiters.empty() && delays.empty()) {
+            return;
+        }
+        const AllocationScope scope(&state);
+        for (const auto& waiter : waiters) {
+            waiter->callback(nullptr);
+        }
+        for (auto& cancel : delays) {
+            cancel();
+        }
+    }
+}
+
+void ReplayHost::trackEntities(EventType type, const void* event)
+{
+    State& state = *m_impl->state;
+    switch (type) {
+    case EventType::AircraftConnected:
+        state.entityTable(Component::EntityKind::Aircraft)
+            .insert(static_cast<const Aircraft::AircraftConnectedEvent*>(event)->callsign);
+        break;
+    case EventType::AircraftDisconnected: {
+        const std::string& callsign
+            = static_cast<const Aircraft::AircraftDisconnectedEvent*>(event)->callsign;
+        state.entityTable(Component::EntityKind::Aircraft).scheduleRemoval(callsign);
+        std::vector<Squawk::DuplicateSquawkEvent> duplicates;
+        std::unique_lock lock(state.dataMutex);
+        state.squawkPool.hold(callsign, std::nullopt, duplicates);
+        state.squawkPool.releaseAllocation(callsign, state.currentTime());
+        state.postDuplicates(duplicates);
+        break;
+    }
+    case EventType::AircraftBeaconCodeChanged: {
+        const auto& change
+            = *static_cast<const ControllerData::AircraftBeaconCodeChangedEvent*>(event);
+        std::vector<Squawk::DuplicateSquawkEvent> duplicates;
+        std::unique_lock lock(state.dataMutex);
+        state.squawkPool.hold(change.callsign, parseSquawk(change.newCode), duplicates);
+        state.postDuplicates(duplicates);
+        break;
+    }
+    case EventType::SquawkAssigned: {
+        const auto& assigned = *static_cast<const Squawk::SquawkAssignedEvent*>(event);
+        if (assigned.callsign && assigned.squawk) {
+            std::vector<Squawk::DuplicateSquawkEvent> duplicates;
+            std::unique_lock lock(state.dataMutex);
+            state.squawkPool.hold(assigned.callsign, parseSquawk(assigned.squawk), duplicates);
+            state.postDuplicates(duplicates);
+        }
+        break;
+    }
+    case EventType::FlightplanUpdated:
+        state.entityTable(Component::EntityKind::Flightplan)
+            .insert(static_cast<const Flightplan::FlightplanUpdatedEvent*>(event)->callsign);
+        break;
+    case EventType::FlightplanRemoved:
+        state.entityTable(Component::EntityKind::Flightplan)
+            .scheduleRemoval(
+                static_cast<const Flightplan::FlightplanRemovedEvent*>(event)->callsign);
+        break;
+    case EventType::ControllerConnected:
+        state.entityTable(Component::EntityKind::Controller)
+            .insert(static_cast<const Controller::ControllerConnectedEvent*>(event)->callsign);
+        break;
+    case EventType::ControllerDisconnected:
+        state.entityTable(Component::EntityKind::Controller)
+            .scheduleRemoval(
+                static_cast<const Controller::ControllerDisconnectedEvent*>(event)->callsign);
+        break;
+    default:
+        break;
+    }
+}
+
+void ReplayHost::applyEntityRemovals()
+{
+    for (EntityTable& table : m_impl->state->entities) {
+        table.applyRemovals();
+    }
+}
+
+std::vector<std::unique_ptr<Recording::RecordedEvent>> ReplayHost::takeHostEvents()
+{
+    State& state = *m_impl->state;
+    std::vector<std::unique_ptr<Recording::RecordedEvent>> events;
+    std::lock_guard lock(state.pendingMutex);
+    events.swap(state.hostEvents);
+    return events;
+}
+
+void ReplayHost::setTickInterval(std::chrono::milliseconds interval)
+{
+    std::lock_guard lock(m_impl->state->timerMutex);
+    m_impl->state->tickInterval = std::max(interval, std::chrono::milliseconds(1));
+}
+
+void ReplayHost::waitForIdle()
+{
+    m_impl->scheduler.waitForIdle();
+    processPending();
+    m_impl->state->logLines.flush();
+}
+
+void ReplayHost::setMetricsInterval(std::chrono::milliseconds interval)
+{
+    m_impl->state->metricsInterval = std::max(interval, std::chrono::milliseconds(0));
+}
+
+void ReplayHost::setLogLevel(Logger::LogLevel level) { m_impl->state->logLevel = level; }
+
+const ReplayCounters& ReplayHost::counters() const { return m_impl->state->counters; }
+
+Package::PackageAPI& ReplayHost::package() { return m_impl->package; }
+Aircraft::AircraftAPI& ReplayHost::aircraft() { return m_impl->aircraft; }
+Flightplan::FlightplanAPI& ReplayHost::flightplan() { return m_impl->flightplan; }
+Controller::ControllerAPI& ReplayHost::controller() { return m_impl->controller; }
+ControllerData::ControllerDataAPI& ReplayHost::controllerData() { return m_impl->controllerData; }
+Airport::AirportAPI& ReplayHost::airport() { return m_impl->airport; }
+Squawk::SquawkAPI& ReplayHost::squawk() { return m_impl->squawk; }
+Tag::TagAPI& ReplayHost::tag() { return m_impl->tag; }
+Logger::LoggerAPI& ReplayHost::logger() { return m_impl->logger; }
+Fsd::FsdAPI& ReplayHost::fsd() { return m_impl->fsd; }
+Chat::ChatAPI& ReplayHost::chat() { return m_impl->chat; }
+Scheduler::SchedulerAPI& ReplayHost::scheduler() { return m_impl->scheduler; }
+Component::ComponentAPI& ReplayHost::component() { return m_impl->component; }
+Metrics::MetricsAPI& ReplayHost::metrics() { return m_impl->metrics; }
+
+PluginCodeScope::PluginCodeScope(ReplayHost& host)
+    : m_previous(allocationOwner)
+{
+    allocationOwner = host.m_impl->state.get();
+}
+
+PluginCodeScope::~PluginCodeScope() { allocationOwner = static_cast<State*>(m_previous); }
+
+void recordAllocation(std::size_t bytes) noexcept
+{
+    allocationsTracked.store(true, std::memory_order_relaxed);
+    if (State* state = allocationOwner) {
+        state->allocations.allocate(bytes);
+    }
+}
+
+void recordDeallocation(std::size_t bytes) noexcept
+{
+    if (State* state = allocationOwner) {
+        state->allocations.deallocate(bytes);
+    }
+}
+
+Dispatch::DispatchStats ReplayHost::getDispatchStats()
+{
+    const IsolatedDispatcher* dispatcher = m_impl->state->dispatcher;
+    return dispatcher ? dispatcher->stats() : Dispatch::DispatchStats {};
+}
+
+ReplayReport replay(Recording::RecordingReader& reader, BasePlugin& plugin, ReplayHost& host,
+    const ReplayOptions& options)
+{
+    constexpr auto eventTypeCount = static_cast<std::size_t>(EventType::Count);
+    std::vector<std::vector<std::chrono::nanoseconds>> samples(eventTypeCount);
+
+    ReplayReport report;
+    host.setPlugin(&plugin);
+    const EventMask subscriptions = plugin.GetEventSubscriptions();
+    const Dispatch::DispatchOptions dispatchOptions = plugin.GetDispatchOptions();
+
+    EventMask batched = plugin.GetBatchedEvents() & subscriptions;
+    batched.reset(EventType::TagShowDropdown);
+    const std::chrono::nanoseconds tickInterval = host.scheduler().getTickInterval();
+    EventBatcher batcher;
+    std::vector<std::chrono::nanoseconds> batchSamples;
+
+    State& state = *host.m_impl->state;
+    const auto flushBatch = [&] {
+        const auto before = Clock::now();
+        {
+            const AllocationScope scope(&state);
+            batcher.flush(plugin);
+        }
+        const auto elapsed = Clock::now() - before;
+        // Freed outside the scope so the host's events are not charged to the plugin
+        batcher.clear();
+        state.batchLatency.record(elapsed.count());
+        state.anyHandlerLatency.record(elapsed.count());
+        batchSamples.push_back(elapsed);
+        report.handlerTime += elapsed;
+        host.processPending();
+    };
+
+    // Runs on the plugin's event thread
+    std::uint64_t currentTick = 0;
+    const auto advance = [&](std::chrono::nanoseconds timestamp) {
+        const std::uint64_t tick = timestamp / tickInterval;
+        if (tick != currentTick) {
+            if (!batcher.empty()) {
+                flushBatch();
+            }
+            host.applyEntityRemovals();
+            host.renderTags();
+            currentTick = tick;
+        }
+        host.advanceTo(timestamp);
+        host.processPending();
+    };
+
+    const auto dispatch = [&](const auto& event, std::chrono::nanoseconds timestamp) {
+        const std::uint64_t tick = timestamp / tickInterval;
+        advance(timestamp);
+        host.trackEntities(event.type(), event.data());
+        host.notifyWaiters(event.type(), event.data());
+        if (!subscriptions.test(event.type())) {
+            host.processPending();
+            return;
+        }
+        if (batched.test(event.type())) {
+            batcher.add(event.take(), tick);
+            return;
+        }
+
+        const auto before = Clock::now();
+        {
+            const AllocationScope scope(&state);
+            if (event.type() == EventType::TagShowDropdown) {
+                const auto& [actionId, callsign]
+                    = *static_cast<const std::pair<std::string, std::string>*>(event.data());
+                if (plugin.OnTagShowDropdown(actionId, callsign)) {
+                    host.showDropdown(actionId, callsign);
+                }
+            } else {
+                event.dispatch(plugin);
+            }
+        }
+        const auto elapsed = Clock::now() - before;
+        state.handlerLatency[static_cast<std::size_t>(event.type())].record(elapsed.count());
+        state.anyHandlerLatency.record(elapsed.count());
+        samples[static_cast<std::size_t>(event.type())].push_back(elapsed);
+        report.handlerTime += elapsed;
+        host.processPending();
+    };
+
+    // Delivering a host event can raise more, so this runs until none are left
+    const auto deliverHostEvents = [&](std::chrono::nanoseconds timestamp) {
+        for (auto events = host.takeHostEvents(); !events.empty();
+             events = host.takeHostEvents()) {
+            for (auto& event : events) {
+                dispatch(OwnedEvent { event }, timestamp);
+            }
+        }
+    };
+
+    std::optional<IsolatedDispatcher> dispatcher;
+    if (dispatchOptions.mode == Dispatch::DispatchMode::Isolated) {
+        dispatcher.emplace(
+            host, dispatchOptions,
+            [&](std::unique_ptr<Recording::RecordedEvent>& event,
+                std::chrono::nanoseconds timestamp) {
+                dispatch(OwnedEvent { event }, timestamp);
+                deliverHostEvents(timestamp);
+            },
+            [&](std::chrono::nanoseconds timestamp) {
+                advance(timestamp);
+                deliverHostEvents(timestamp);
+            });
+        state.dispatcher = &*dispatcher;
+    }
+
+    // Records not delivered still move the clock, once per tick, so timers fire
+    std::uint64_t skippedTick = 0;
+    const auto skip = [&](std::chrono::nanoseconds timestamp) {
+        const std::uint64_t tick = timestamp / tickInterval;
+        if (tick == skippedTick) {
+            return;
+        }
+        skippedTick = tick;
+        if (dispatcher) {
+            dispatcher->pushTick(timestamp);
+        } else {
+            advance(timestamp);
+            deliverHostEvents(timestamp);
+        }
+    };
+
+    const auto start = Clock::now();
+    while (reader.next()) {
+        report.recordedDuration = reader.timestamp();
+        if (reader.kind() == Recording::RecordKind::Snapshot) {
+            if (dispatcher) {
+                dispatcher->push(std::make_shared<const Recording::Snapshot>(reader.snapshot()));
+            } else {
+                host.setSnapshot(reader.snapshot());
+                deliverHostEvents(reader.timestamp());
+            }
+            continue;
+        }
+        // The host raises DuplicateSquawk itself from the codes it tracks
+        if (reader.eventType() == EventType::DuplicateSquawk) {
+            skip(reader.timestamp());
+            continue;
+        }
+        if (!host.receiveMessage(reader.eventType(), reader.event())) {
+            ++report.skippedMessages;
+            skip(reader.timestamp());
+            continue;
+        }
+        const bool waited = dispatcher ? host.getWaitedEvents().test(reader.eventType())
+                                       : host.hasWaiters(reader.eventType());
+        if (!subscriptions.test(reader.eventType()) && !waited
+            && !EntityEvents.test(reader.eventType())) {
+            ++report.unsubscribedEvents;
+            skip(reader.timestamp());
+            continue;
+        }
+
+        if (options.speed > 0) {
+            const auto due = start
+                + std::chrono::duration_cast<Clock::duration>(reader.timestamp() / options.speed);
+            std::this_thread::sleep_until(due);
+        }
+
+        ++report.events;
+        if (dispatcher) {
+            dispatcher->push(reader.takeEvent(), reader.timestamp());
+        } else {
+            dispatch(ReaderEvent { reader }, reader.timestamp());
+            deliverHostEvents(reader.timestamp());
+        }
+    }
+
+    if (dispatcher) {
+        dispatcher->finish();
+    }
+    if (!batcher.empty()) {
+        flushBatch();
+    }
+    host.applyEntityRemovals();
+    if (dispatcher) {
+        report.dispatch = dispatcher->stats();
+        state.dispatcher = nullptr;
+    }
+    host.advanceTo(report.recordedDuration);
+    host.waitForIdle();
+    // Raised by the last snapshot, or by work finishing after the last event
+    deliverHostEvents(report.recordedDuration);
+    if (!batcher.empty()) {
+        flushBatch();
+    }
+    // Nothing is left to merge with once the recording ends
+    sendClientMessages(state, std::chrono::nanoseconds::max());
+    report.complete = reader.kind() == Recording::RecordKind::End;
+    report.wallTime = Clock::now() - start;
+
+    const auto summarize = [](EventType type, std::vector<std::chrono::nanoseconds>& durations) {
+        EventLatency latency { type };
+        if (durations.empty()) {
+            return latency;
+        }
+        std::sort(durations.begin(), durations.end());
+        latency.count = durations.size();
+        for (const auto duration : durations) {
+            latency.total += duration;
+        }
+        latency.p50 = durations[(durations.size() - 1) / 2];
+        latency.p99 = durations[(durations.size() - 1) * 99 / 100];
+        latency.max = durations.back();
+        return latency;
+    };
+    for (std::size_t type = 0; type < eventTypeCount; ++type) {
+        if (!samples[type].empty()) {
+            report.latencies.push_back(summarize(static_cast<EventType>(type), samples[type]));
+        }
+    }
+    report.batches = summarize(EventType::Count, batchSamples);
+    return report;
+}
+
+} // namespace PluginSDK::Replay
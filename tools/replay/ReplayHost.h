@@ -0,0 +1,311 @@
+#pragma once
+#include <NeoRadarSDK/Recording.h>
+#include <NeoRadarSDK/SDK.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace PluginSDK::Replay {
+
+/**
+ * @struct ReplayCounters
+ * @brief Number of CoreAPI calls made by the plugin during a replay
+ *
+ * Counted from every thread the plugin calls the host on.
+ */
+struct ReplayCounters {
+    std::atomic<std::uint64_t> queries { 0 };
+    std::atomic<std::uint64_t> writes { 0 };
+    std::atomic<std::uint64_t> tagUpdates { 0 };
+    std::atomic<std::uint64_t> messagesSent { 0 };
+    std::atomic<std::uint64_t> logMessages { 0 };
+};
+
+struct ReplayOptions;
+struct ReplayReport;
+class PluginCodeScope;
+
+/**
+ * @class ReplayHost
+ * @brief CoreAPI implementation answering queries from a recording
+ *
+ * Queries are served from the latest Recording::Snapshot. Write operations are
+ * accepted and counted but do not change the recorded state.
+ */
+class ReplayHost : public CoreAPI {
+public:
+    ReplayHost();
+    ~ReplayHost() override;
+
+    ReplayHost(const ReplayHost&) = delete;
+    ReplayHost& operator=(const ReplayHost&) = delete;
+
+    /**
+     * @brief Set the plugin receiving host-initiated events (e.g. squawk assignments)
+     */
+    void setPlugin(BasePlugin* plugin);
+
+    /**
+     * @brief Replace the state served by queries
+     */
+    void setSnapshot(const Recording::Snapshot& snapshot);
+
+    /**
+     * @brief Add a received message to the chat history
+     * @param type Message event type
+     * @param event Event struct matching type
+     * @return True if one of the plugin's message subscriptions accepts it
+     */
+    bool receiveMessage(EventType type, const void* event);
+
+    /**
+     * @brief Run a plugin command as if typed in the chat box
+     * @param line Command line, e.g. ".speed DLH123 250"; the dot is optional
+     * @return Result of the provider's ExecuteParsed, a failure naming the
+     * rejected argument, or nullopt if no command has that name
+     *
+     * Arguments are split on whitespace, or to the end of the line for the last
+     * parameter when lastParameterHasSpaces is set, and checked against the
+     * parameter types and lengths before the provider is called. Call from the
+     * thread dispatching the plugin's events.
+     */
+    std::optional<Chat::CommandResult> executeCommand(const std::string& line);
+
+    /**
+     * @brief Run work the host deferred to its own thread, such as squawk assignments
+     *
+     * Call from the thread dispatching the plugin's events.
+     */
+    void processPending();
+
+    /**
+     * @brief Show the dropdown of an action, fetching the rows in view of its virtualized
+     * ScrollArea components
+     *
+     * Rows stay cached per callsign until Tag::TagInterface::InvalidateScrollAreaItems.
+     * Call from the thread dispatching the plugin's events, after OnTagShowDropdown
+     * returned true.
+     */
+    void showDropdown(const std::string& actionId, const std::string& callsign);
+
+    /**
+     * @brief Render one frame of tags, asking providers for the visible values not cached
+     *
+     * Every aircraft of the current snapshot counts as visible, and requests
+     * carry no list ID. Each provider gets one ProvideTagValues call with the
+     * requests of all its tags. Its values are cached until InvalidateTagValue
+     * or InvalidateTagValues; requests left without a value are asked again
+     * next frame. Call from the thread dispatching the plugin's
+     * events; replay does so once per tick.
+     */
+    void renderTags();
+
+    /**
+     * @brief Advance the replay clock, running the scheduler timers due by the last tick passed
+     * @param time Recording time
+     *
+     * Call from the thread dispatching the plugin's events.
+     */
+    void advanceTo(std::chrono::nanoseconds time);
+
+    /**
+     * @brief Check whether the plugin waits for an event type (see Scheduler::SchedulerAPI::waitForEvent)
+     */
+    bool hasWaiters(EventType type) const;
+
+    /**
+     * @brief Get the event types the plugin has waited for so far
+     */
+    EventMask getWaitedEvents() const;
+
+    /**
+     * @brief Complete the waits accepting an event, before it is dispatched
+     *
+     * Call from the thread dispatching the plugin's events.
+     */
+    void notifyWaiters(EventType type, const void* event);
+
+    /**
+     * @brief Cancel the plugin's pending event waits and delays, calling their callbacks
+     *
+     * Call from the thread dispatching the plugin's events, before Shutdown.
+     */
+    void cancelWaits();
+
+    /**
+     * @brief Update the entity records components attach to from an event
+     *
+     * Connect events create records right away; disconnect and removal events
+     * only mark them, see applyEntityRemovals. Call from the thread dispatching
+     * the plugin's events, before the event is delivered.
+     */
+    void trackEntities(EventType type, const void* event);
+
+    /**
+     * @brief Remove the entity records marked by events or snapshots, destroying their components
+     *
+     * Call from the thread dispatching the plugin's events, once the removal
+     * events have been delivered, batches included.
+     */
+    void applyEntityRemovals();
+
+    /**
+     * @brief Take the events the host raised itself, oldest first
+     *
+     * Snapshots and tracked events raise DuplicateSquawk when a code gains a
+     * second holder or goes back to one, and assignSquawks raises SquawkAssigned
+     * from the scheduler pool. replay delivers them right after the event that
+     * raised them, or at the next event or tick, like recorded events.
+     */
+    std::vector<std::unique_ptr<Recording::RecordedEvent>> takeHostEvents();
+
+    /**
+     * @brief Set the tick interval scheduler timers are batched to
+     */
+    void setTickInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Log the plugin's metrics every interval of recording time; 0 disables
+     *
+     * The lines go to the host log at Info level, so they only show with
+     * setLogLevel(Info) or more.
+     */
+    void setMetricsInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Wait for the worker pool to go idle, then run the main-thread tasks it posted
+     */
+    void waitForIdle();
+
+    /**
+     * @brief Set the most verbose level echoed to stderr
+     */
+    void setLogLevel(Logger::LogLevel level);
+
+    const ReplayCounters& counters() const;
+
+    Package::PackageAPI& package() override;
+    Aircraft::AircraftAPI& aircraft() override;
+    Flightplan::FlightplanAPI& flightplan() override;
+    Controller::ControllerAPI& controller() override;
+    ControllerData::ControllerDataAPI& controllerData() override;
+    Airport::AirportAPI& airport() override;
+    Squawk::SquawkAPI& squawk() override;
+    Tag::TagAPI& tag() override;
+    Logger::LoggerAPI& logger() override;
+    Fsd::FsdAPI& fsd() override;
+    Chat::ChatAPI& chat() override;
+    Scheduler::SchedulerAPI& scheduler() override;
+    Component::ComponentAPI& component() override;
+    Metrics::MetricsAPI& metrics() override;
+    Dispatch::DispatchStats getDispatchStats() override;
+
+    struct Impl;
+
+private:
+    friend ReplayReport replay(Recording::RecordingReader& reader, BasePlugin& plugin,
+        ReplayHost& host, const ReplayOptions& options);
+    friend class PluginCodeScope;
+
+    std::unique_ptr<Impl> m_impl;
+};
+
+/**
+ * @class PluginCodeScope
+ * @brief Attributes heap allocations on this thread to a host's plugin while alive
+ *
+ * The host sets this scope itself around handlers, timers and tasks; use it
+ * around other calls into the plugin, such as Initialize and Shutdown.
+ */
+class PluginCodeScope {
+public:
+    explicit PluginCodeScope(ReplayHost& host);
+    ~PluginCodeScope();
+
+    PluginCodeScope(const PluginCodeScope&) = delete;
+    PluginCodeScope& operator=(const PluginCodeScope&) = delete;
+
+private:
+    void* m_previous;
+};
+
+/**
+ * @brief Report a heap allocation, from a replacement operator new
+ *
+ * Allocation metrics are only available when the executable loading the
+ * plugin replaces the global allocation functions and reports through these.
+ * Both functions are safe to call from any thread and never allocate.
+ */
+void recordAllocation(std::size_t bytes) noexcept;
+
+/**
+ * @brief Report a heap deallocation, from a replacement operator delete
+ */
+void recordDeallocation(std::size_t bytes) noexcept;
+
+/**
+ * @struct ReplayOptions
+ * @brief Pacing of a replay
+ */
+struct ReplayOptions {
+    // Multiple of the recorded speed; 0 replays as fast as possible
+    double speed = 1.0;
+};
+
+/**
+ * @struct EventLatency
+ * @brief Handler latency distribution of one event type
+ */
+struct EventLatency {
+    EventType type;
+    std::uint64_t count = 0;
+    std::chrono::nanoseconds total { 0 };
+    std::chrono::nanoseconds p50 { 0 };
+    std::chrono::nanoseconds p99 { 0 };
+    std::chrono::nanoseconds max { 0 };
+};
+
+/**
+ * @struct ReplayReport
+ * @brief Result of a replay
+ */
+struct ReplayReport {
+    std::uint64_t events = 0;
+    std::uint64_t skippedMessages = 0;
+    std::uint64_t unsubscribedEvents = 0;
+    std::chrono::nanoseconds recordedDuration { 0 };
+    std::chrono::nanoseconds wallTime { 0 };
+    std::chrono::nanoseconds handlerTime { 0 };
+    std::vector<EventLatency> latencies;
+    // OnEventBatch calls; type is EventType::Count
+    EventLatency batches { EventType::Count };
+    // Queue counters when the plugin uses Dispatch::DispatchMode::Isolated
+    Dispatch::DispatchStats dispatch;
+    bool complete = false;
+};
+
+/**
+ * @brief Deliver the events of a recording to an initialized plugin
+ * @param reader Opened recording
+ * @param plugin Plugin receiving the events
+ * @param host Host the plugin was initialized with
+ * @param options Pacing options
+ *
+ * Events outside the plugin's BasePlugin::GetEventSubscriptions mask are
+ * skipped, as the host would not dispatch them. Plugins asking for
+ * Dispatch::DispatchMode::Isolated receive events on a worker thread through a
+ * queue honouring their options; the queue is drained before returning. Events
+ * in BasePlugin::GetBatchedEvents are delivered per scheduler tick through
+ * OnEventBatch.
+ * @return Throughput and per-event latency figures
+ */
+ReplayReport replay(Recording::RecordingReader& reader, BasePlugin& plugin, ReplayHost& host,
+    const ReplayOptions& options);
+
+} // namespace PluginSDK::Replay
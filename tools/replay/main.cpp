@@ -0,0 +1,316 @@
+// neoradar-replay - replays a recording (.nrrec) into a plugin and reports handler latencies
+//
+// Usage: neoradar-replay [--speed <factor>|max] [--log-level <level>]
+//                        [--metrics-interval <seconds>] [--command <line>]...
+//                        <recording.nrrec> <plugin>
+//
+// --metrics-interval dumps the plugin's metrics to the host log at Info level,
+// so it needs --log-level info or more to show.
+
+#include "ReplayHost.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+
+// Replacement allocation functions reporting to the replay host. The
+// executable exports them, so the plugin's allocations resolve here too.
+void* operator new(std::size_t size)
+{
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    PluginSDK::Replay::recordAllocation(malloc_usable_size(memory));
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (memory) {
+        PluginSDK::Replay::recordDeallocation(malloc_usable_size(memory));
+        std::free(memory);
+    }
+}
+
+void operator delete(void* memory, std::size_t) noexcept { operator delete(memory); }
+#endif
+
+using namespace PluginSDK;
+
+namespace {
+
+class PluginLibrary {
+public:
+    ~PluginLibrary()
+    {
+        if (!m_handle) {
+            return;
+        }
+#if defined(_WIN32)
+        FreeLibrary(static_cast<HMODULE>(m_handle));
+#else
+        dlclose(m_handle);
+#endif
+    }
+
+    bool load(const std::string& path)
+    {
+#if defined(_WIN32)
+        m_handle = LoadLibraryA(path.c_str());
+#else
+        m_handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+        return m_handle != nullptr;
+    }
+
+    template <typename Function> Function symbol(const char* name) const
+    {
+#if defined(_WIN32)
+        return reinterpret_cast<Function>(GetProcAddress(static_cast<HMODULE>(m_handle), name));
+#else
+        return reinterpret_cast<Function>(dlsym(m_handle, name));
+#endif
+    }
+
+    std::string error() const
+    {
+#if defined(_WIN32)
+        return "error " + std::to_string(GetLastError());
+#else
+        const char* message = dlerror();
+        return message ? message : "unknown error";
+#endif
+    }
+
+private:
+    void* m_handle = nullptr;
+};
+
+bool parseLogLevel(const std::string& name, Logger::LogLevel& level)
+{
+    static const std::pair<const char*, Logger::LogLevel> levels[] = {
+        { "fatal", Logger::LogLevel::Fatal },
+        { "error", Logger::LogLevel::Error },
+        { "warning", Logger::LogLevel::Warning },
+        { "info", Logger::LogLevel::Info },
+        { "debug", Logger::LogLevel::Debug },
+        { "verbose", Logger::LogLevel::Verbose },
+    };
+    for (const auto& [levelName, value] : levels) {
+        if (name == levelName) {
+            level = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+double toMicroseconds(std::chrono::nanoseconds duration) { return duration.count() / 1000.0; }
+
+void printReport(const Replay::ReplayReport& report, const Replay::ReplayCounters& counters)
+{
+    const double wallSeconds = report.wallTime.count() / 1e9;
+    std::printf("events:          %llu (%llu not subscribed, %llu messages filtered)\n",
+        static_cast<unsigned long long>(report.events),
+        static_cast<unsigned long long>(report.unsubscribedEvents),
+        static_cast<unsigned long long>(report.skippedMessages));
+    std::printf("recorded:        %.3f s\n", report.recordedDuration.count() / 1e9);
+    std::printf("wall time:       %.3f s\n", wallSeconds);
+    std::printf("handler time:    %.3f s\n", report.handlerTime.count() / 1e9);
+    if (wallSeconds > 0) {
+        std::printf("throughput:      %.0f events/s\n", report.events / wallSeconds);
+    }
+    std::printf("api calls:       %llu queries, %llu writes, %llu tag updates, %llu messages, "
+                "%llu log messages\n",
+        static_cast<unsigned long long>(counters.queries.load()),
+        static_cast<unsigned long long>(counters.writes.load()),
+        static_cast<unsigned long long>(counters.tagUpdates.load()),
+        static_cast<unsigned long long>(counters.messagesSent.load()),
+        static_cast<unsigned long long>(counters.logMessages.load()));
+    if (report.dispatch.mode == Dispatch::DispatchMode::Isolated) {
+        const Dispatch::DispatchStats& queue = report.dispatch;
+        std::printf("isolated queue:  max depth %zu/%zu, %llu dropped, %llu merged, "
+                    "max lag %.2f ms, blocked %.2f ms\n",
+            queue.maxQueueDepth, queue.capacity, static_cast<unsigned long long>(queue.dropped),
+            static_cast<unsigned long long>(queue.merged), queue.maxLag.count() / 1e6,
+            queue.blocked.count() / 1e6);
+    }
+    if (!report.complete) {
+        std::printf("warning:         recording is truncated or malformed\n");
+    }
+
+    std::printf("\n%-36s %10s %12s %12s %12s\n", "event", "count", "p50 (us)", "p99 (us)",
+        "max (us)");
+    for (const Replay::EventLatency& latency : report.latencies) {
+        std::printf("%-36s %10llu %12.2f %12.2f %12.2f\n", GetEventTypeName(latency.type),
+            static_cast<unsigned long long>(latency.count), toMicroseconds(latency.p50),
+            toMicroseconds(latency.p99), toMicroseconds(latency.max));
+    }
+    if (report.batches.count > 0) {
+        const Replay::EventLatency& latency = report.batches;
+        std::printf("%-36s %10llu %12.2f %12.2f %12.2f\n", "EventBatch",
+            static_cast<unsigned long long>(latency.count), toMicroseconds(latency.p50),
+            toMicroseconds(latency.p99), toMicroseconds(latency.max));
+    }
+}
+
+void printMetrics(const Metrics::PluginMetrics& metrics)
+{
+    if (!metrics.apiCalls.empty()) {
+        std::printf("\n%-36s %10s %12s %12s %12s\n", "CoreAPI call", "count", "p50 (us)",
+            "p99 (us)", "max (us)");
+        for (const Metrics::ApiMetrics& api : metrics.apiCalls) {
+            std::printf("%-36s %10llu %12.2f %12.2f %12.2f\n", Metrics::GetApiName(api.api),
+                static_cast<unsigned long long>(api.latency.count),
+                toMicroseconds(api.latency.p50), toMicroseconds(api.latency.p99),
+                toMicroseconds(api.latency.max));
+        }
+    }
+
+    if (metrics.taskExceptions > 0) {
+        std::printf("\ntask exceptions: %llu\n",
+            static_cast<unsigned long long>(metrics.taskExceptions));
+    }
+
+    const Metrics::AllocationMetrics& heap = metrics.allocations;
+    if (heap.tracked) {
+        std::printf("\nheap:            %llu allocations (%.1f KiB), %llu frees, "
+                    "%.1f KiB live, %.1f KiB peak\n",
+            static_cast<unsigned long long>(heap.allocations), heap.allocatedBytes / 1024.0,
+            static_cast<unsigned long long>(heap.deallocations), heap.liveBytes / 1024.0,
+            heap.peakLiveBytes / 1024.0);
+    }
+}
+
+void printUsage(const char* program, std::ostream& out)
+{
+    out << "Usage: " << program
+        << " [--speed <factor>|max] [--log-level <level>] [--metrics-interval <seconds>]"
+           " [--command <line>]... <recording.nrrec> <plugin>\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Replay::ReplayOptions options;
+    Logger::LogLevel logLevel = Logger::LogLevel::Warning;
+    double metricsInterval = 0;
+    std::vector<std::string> commands;
+    std::string recordingPath;
+    std::string pluginPath;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "-h" || argument == "--help") {
+            printUsage(argv[0], std::cout);
+            return 0;
+        } else if (argument == "--speed" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            options.speed = value == "max" ? 0.0 : std::strtod(value.c_str(), nullptr);
+            if (options.speed < 0) {
+                printUsage(argv[0], std::cerr);
+                return 2;
+            }
+        } else if (argument == "--log-level" && i + 1 < argc) {
+            if (!parseLogLevel(argv[++i], logLevel)) {
+                std::cerr << "Unknown log level: " << argv[i] << "\n";
+                return 2;
+            }
+        } else if (argument == "--metrics-interval" && i + 1 < argc) {
+            metricsInterval = std::strtod(argv[++i], nullptr);
+            if (metricsInterval < 0) {
+                printUsage(argv[0], std::cerr);
+                return 2;
+            }
+        } else if (argument == "--command" && i + 1 < argc) {
+            commands.push_back(argv[++i]);
+        } else if (recordingPath.empty()) {
+            recordingPath = argument;
+        } else if (pluginPath.empty()) {
+            pluginPath = argument;
+        } else {
+            printUsage(argv[0], std::cerr);
+            return 2;
+        }
+    }
+    if (pluginPath.empty()) {
+        printUsage(argv[0], std::cerr);
+        return 2;
+    }
+
+    Recording::RecordingReader reader;
+    if (!reader.open(recordingPath)) {
+        std::cerr << recordingPath << ": not a readable recording\n";
+        return 1;
+    }
+
+    PluginLibrary library;
+    if (!library.load(pluginPath)) {
+        std::cerr << pluginPath << ": " << library.error() << "\n";
+        return 1;
+    }
+    const auto getVersionMajor = library.symbol<int (*)()>("GetPluginSDKVersionMajor");
+    const auto createInstance = library.symbol<BasePlugin* (*)()>("CreatePluginInstance");
+    if (!getVersionMajor || !createInstance) {
+        std::cerr << pluginPath << ": not a NeoRadar plugin\n";
+        return 1;
+    }
+    if (getVersionMajor() != PLUGIN_SDK_VERSION_MAJOR) {
+        std::cerr << pluginPath << ": built against SDK major version " << getVersionMajor()
+                  << ", expected " << PLUGIN_SDK_VERSION_MAJOR << "\n";
+        return 1;
+    }
+
+    Replay::ReplayReport report;
+    Replay::ReplayHost host;
+    host.setLogLevel(logLevel);
+    host.setMetricsInterval(std::chrono::milliseconds(std::llround(metricsInterval * 1000)));
+    {
+        std::unique_ptr<BasePlugin> plugin(createInstance());
+        if (!plugin) {
+            std::cerr << pluginPath << ": CreatePluginInstance returned null\n";
+            return 1;
+        }
+        {
+            const Replay::PluginCodeScope scope(host);
+            plugin->Initialize(reader.metadata(), &host, reader.clientInformation());
+        }
+        report = Replay::replay(reader, *plugin, host, options);
+        // Commands run once the recording is over, as typed by the controller
+        for (const std::string& command : commands) {
+            const auto result = host.executeCommand(command);
+            host.processPending();
+            if (!result) {
+                std::printf("command %s: not registered\n", command.c_str());
+            } else {
+                std::printf("command %s: %s%s%s\n", command.c_str(),
+                    result->success ? "ok" : "failed", result->message ? ", " : "",
+                    result->message ? result->message->c_str() : "");
+            }
+        }
+        host.cancelWaits();
+        host.processPending();
+        const Replay::PluginCodeScope scope(host);
+        plugin->Shutdown();
+    }
+
+    printReport(report, host.counters());
+    printMetrics(host.metrics().getMetrics());
+    return report.complete ? 0 : 1;
+}